@@ -0,0 +1,28 @@
+#shader vertex
+#version 330 core
+
+void main()
+{
+    // Vertices 0, 1 and 2 make a triangle twice the size of the viewport, which covers all of it.
+    vec2 corner = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);
+};
+
+
+#shader fragment
+#version 330 core
+
+// One texel per cell, non-zero for alive cells.
+uniform sampler2D u_Cells;
+uniform ivec2 u_GridSize;
+uniform vec2 u_ViewportSize;
+
+out vec4 fragmentColour;
+
+void main()
+{
+    // Row 0 of the grid is at the bottom of the window, as with the vertex renderer.
+    ivec2 cell = min(ivec2(gl_FragCoord.xy / u_ViewportSize * vec2(u_GridSize)), u_GridSize - 1);
+    float state = texelFetch(u_Cells, cell, 0).r > 0.0 ? 1.0 : 0.0;
+    fragmentColour = vec4(vec3(state), 1.0);
+};
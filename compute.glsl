@@ -0,0 +1,87 @@
+#shader compute
+#version 430 core
+
+// Must match ComputeEngine::workgroupSize.
+layout(local_size_x = 16, local_size_y = 16) in;
+
+layout(std430, binding = 0) readonly buffer CurrentCells
+{
+    uint currentCells[];
+};
+
+layout(std430, binding = 1) writeonly buffer NextCells
+{
+    uint nextCells[];
+};
+
+uniform ivec2 u_GridSize;
+
+// 0 for dead edges, 1 for toroidal, 2 for mirror, as in EdgeMode.
+uniform int u_EdgeMode;
+
+uint CellAt(ivec2 cell)
+{
+    if (u_EdgeMode == 1) {
+        cell = (cell + u_GridSize) % u_GridSize;
+    } else if (u_EdgeMode == 2) {
+        cell = clamp(cell, ivec2(0), u_GridSize - 1);
+    } else if (any(lessThan(cell, ivec2(0))) || any(greaterThanEqual(cell, u_GridSize))) {
+        return 0u;
+    }
+
+    return currentCells[cell.y * u_GridSize.x + cell.x];
+}
+
+void main()
+{
+    const ivec2 cell = ivec2(gl_GlobalInvocationID.xy);
+    if (any(greaterThanEqual(cell, u_GridSize))) {
+        return;
+    }
+
+    uint nNeighbours = 0u;
+    for (int dy = -1; dy <= 1; ++dy) {
+        for (int dx = -1; dx <= 1; ++dx) {
+            if (dx != 0 || dy != 0) {
+                nNeighbours += CellAt(cell + ivec2(dx, dy));
+            }
+        }
+    }
+
+    const int index = cell.y * u_GridSize.x + cell.x;
+    const bool alive = currentCells[index] != 0u;
+    nextCells[index] = (nNeighbours == 3u || (alive && nNeighbours == 2u)) ? 1u : 0u;
+};
+
+
+#shader vertex
+#version 430 core
+
+void main()
+{
+    // Vertices 0, 1 and 2 make a triangle twice the size of the viewport, which covers all of it.
+    const vec2 corner = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);
+};
+
+
+#shader fragment
+#version 430 core
+
+layout(std430, binding = 0) readonly buffer Cells
+{
+    uint cells[];
+};
+
+uniform ivec2 u_GridSize;
+uniform vec2 u_ViewportSize;
+
+out vec4 fragmentColour;
+
+void main()
+{
+    // Row 0 of the grid is at the bottom of the window, as with the vertex renderer.
+    const ivec2 cell = min(ivec2(gl_FragCoord.xy / u_ViewportSize * vec2(u_GridSize)), u_GridSize - 1);
+    const float state = float(cells[cell.y * u_GridSize.x + cell.x]);
+    fragmentColour = vec4(vec3(state), 1.0);
+};
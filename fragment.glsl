@@ -0,0 +1,33 @@
+#shader vertex
+#version 330 core
+
+void main()
+{
+    // Vertices 0, 1 and 2 make a triangle twice the size of the viewport, which covers all of it.
+    vec2 corner = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);
+};
+
+
+#shader fragment
+#version 330 core
+
+// The current generation, 1/255 for alive cells. Past the edges, the wrap mode decides what is read.
+uniform sampler2D u_Cells;
+uniform vec2 u_GridSize;
+
+out float nextState;
+
+void main()
+{
+    // One fragment per cell, at the centre of its texel. Offsets must be constant, so the neighbours are spelled out.
+    vec2 position = gl_FragCoord.xy / u_GridSize;
+    float sum = textureOffset(u_Cells, position, ivec2(-1, -1)).r + textureOffset(u_Cells, position, ivec2(0, -1)).r
+        + textureOffset(u_Cells, position, ivec2(1, -1)).r + textureOffset(u_Cells, position, ivec2(-1, 0)).r
+        + textureOffset(u_Cells, position, ivec2(1, 0)).r + textureOffset(u_Cells, position, ivec2(-1, 1)).r
+        + textureOffset(u_Cells, position, ivec2(0, 1)).r + textureOffset(u_Cells, position, ivec2(1, 1)).r;
+    int nNeighbours = int(round(sum * 255.0));
+    bool alive = texture(u_Cells, position).r > 0.0;
+
+    nextState = (nNeighbours == 3 || (alive && nNeighbours == 2)) ? 1.0 / 255.0 : 0.0;
+};
@@ -0,0 +1,38 @@
+#shader vertex
+#version 330 core
+
+// A corner of the unit quad, and the state of the cell this instance draws.
+layout(location = 0) in vec2 corner;
+layout(location = 1) in uint state;
+
+out vec3 outVertexColour;
+
+// For Orthographic projection matrix
+uniform mat4 u_MVP;
+uniform float u_CellSize;
+
+// Instances follow the rows of the grid, halo included, so some of them fall on the halo and draw nothing.
+uniform int u_Stride;
+uniform int u_GridWidth;
+
+void main()
+{
+    int x = gl_InstanceID % u_Stride;
+    int y = gl_InstanceID / u_Stride;
+    vec2 position = (vec2(x, y) + corner) * u_CellSize;
+
+    gl_Position = x < u_GridWidth ? u_MVP * vec4(position, 0.0, 1.0) : vec4(0.0);
+    outVertexColour = vec3(state != 0u ? 1.0 : 0.0);
+};
+
+
+#shader fragment
+#version 330 core
+
+in vec3 outVertexColour;
+out vec4 fragmentColour;
+
+void main()
+{
+    fragmentColour = vec4(outVertexColour, 1.0);
+};
@@ -0,0 +1,167 @@
+#shader compute
+#version 430 core
+
+// Must match PackedComputeEngine::workgroupWords and workgroupRows.
+#define TILE_WORDS 16
+#define TILE_ROWS 16
+
+layout(local_size_x = TILE_WORDS, local_size_y = TILE_ROWS) in;
+
+// 32 cells per word, row after row of u_WordsPerRow words. Bits past the width of the grid are 0.
+layout(std430, binding = 0) readonly buffer CurrentCells
+{
+    uint currentCells[];
+};
+
+layout(std430, binding = 1) writeonly buffer NextCells
+{
+    uint nextCells[];
+};
+
+uniform ivec2 u_GridSize;
+uniform int u_WordsPerRow;
+
+// 0 for dead edges, 1 for toroidal, 2 for mirror, as in EdgeMode.
+uniform int u_EdgeMode;
+
+// The workgroup's words with a halo of one word either side, and one row above and below.
+shared uint tile[TILE_ROWS + 2][TILE_WORDS + 2];
+
+uint CellAt(int x, int y)
+{
+    return (currentCells[y * u_WordsPerRow + (x >> 5)] >> (x & 31)) & 1u;
+}
+
+// The word at column w of row y, with the cells just past the left and right edges of the grid placed where the
+// shifts in StepWord() expect them: bit 31 of word -1, and the bit after the last cell of the row.
+uint WordAt(int w, int y)
+{
+    if (u_EdgeMode == 1) {
+        y = (y + u_GridSize.y) % u_GridSize.y;
+    } else if (u_EdgeMode == 2) {
+        y = clamp(y, 0, u_GridSize.y - 1);
+    } else if (y < 0 || y >= u_GridSize.y) {
+        return 0u;
+    }
+
+    // Past the left and right edges, the toroidal grid wraps around and the mirror repeats the edge cell.
+    uint left = 0u;
+    uint right = 0u;
+    if (u_EdgeMode == 1) {
+        left = CellAt(u_GridSize.x - 1, y);
+        right = CellAt(0, y);
+    } else if (u_EdgeMode == 2) {
+        left = CellAt(0, y);
+        right = CellAt(u_GridSize.x - 1, y);
+    }
+
+    int nTrailingBits = u_GridSize.x & 31;
+    if (w == -1) {
+        return left << 31;
+    } else if (w == u_WordsPerRow) {
+        return nTrailingBits == 0 ? right : 0u;
+    } else if (w < 0 || w > u_WordsPerRow) {
+        return 0u;
+    }
+
+    uint word = currentCells[y * u_WordsPerRow + w];
+    if (w == u_WordsPerRow - 1 && nTrailingBits != 0) {
+        word |= right << nTrailingBits;
+    }
+    return word;
+}
+
+// Evaluate B3/S23 for the 32 cells of a word with full-adder logic, as BitboardEngine does for 64.
+uint StepWord(uint aboveWest, uint above, uint aboveEast, uint middleWest, uint middle, uint middleEast, uint belowWest, uint below, uint belowEast)
+{
+    // Full adders over each row of neighbours. The "ones" bits have weight 1 and the "twos" bits weight 2.
+    uint aboveOnes = aboveWest ^ above ^ aboveEast;
+    uint aboveTwos = (aboveWest & above) | (aboveEast & (aboveWest ^ above));
+    uint middleOnes = middleWest ^ middleEast;
+    uint middleTwos = middleWest & middleEast;
+    uint belowOnes = belowWest ^ below ^ belowEast;
+    uint belowTwos = (belowWest & below) | (belowEast & (belowWest ^ below));
+
+    // Add the three weight 1 bits, carrying into weight 2.
+    uint ones = aboveOnes ^ middleOnes ^ belowOnes;
+    uint onesCarry = (aboveOnes & middleOnes) | (belowOnes & (aboveOnes ^ middleOnes));
+
+    // A count of 2 or 3 needs exactly one of the four weight 2 bits to be set.
+    uint pairA = aboveTwos ^ middleTwos;
+    uint pairB = belowTwos ^ onesCarry;
+    uint exactlyOneTwo = (pairA ^ pairB) & ~(aboveTwos & middleTwos) & ~(belowTwos & onesCarry);
+
+    return exactlyOneTwo & (ones | middle);
+}
+
+uint West(uint previous, uint word) { return (word << 1) | (previous >> 31); }
+uint East(uint word, uint next) { return (word >> 1) | (next << 31); }
+
+void main()
+{
+    ivec2 tileOrigin = ivec2(gl_WorkGroupID.xy) * ivec2(TILE_WORDS, TILE_ROWS);
+
+    // Load the tile and its halo, (TILE_WORDS + 2) * (TILE_ROWS + 2) words between the workgroup's invocations.
+    const int nTileWords = (TILE_WORDS + 2) * (TILE_ROWS + 2);
+    for (int i = int(gl_LocalInvocationIndex); i < nTileWords; i += TILE_WORDS * TILE_ROWS) {
+        int column = i % (TILE_WORDS + 2);
+        int row = i / (TILE_WORDS + 2);
+        tile[row][column] = WordAt(tileOrigin.x + column - 1, tileOrigin.y + row - 1);
+    }
+    barrier();
+
+    ivec2 word = ivec2(gl_GlobalInvocationID.xy);
+    if (word.x >= u_WordsPerRow || word.y >= u_GridSize.y) {
+        return;
+    }
+
+    ivec2 local = ivec2(gl_LocalInvocationID.xy) + 1;
+    uint above = tile[local.y - 1][local.x];
+    uint middle = tile[local.y][local.x];
+    uint below = tile[local.y + 1][local.x];
+    uint next = StepWord(West(tile[local.y - 1][local.x - 1], above), above, East(above, tile[local.y - 1][local.x + 1]),
+        West(tile[local.y][local.x - 1], middle), middle, East(middle, tile[local.y][local.x + 1]),
+        West(tile[local.y + 1][local.x - 1], below), below, East(below, tile[local.y + 1][local.x + 1]));
+
+    // Keep the bits past the width of the grid dead.
+    int nTrailingBits = u_GridSize.x & 31;
+    if (word.x == u_WordsPerRow - 1 && nTrailingBits != 0) {
+        next &= (1u << nTrailingBits) - 1u;
+    }
+    nextCells[word.y * u_WordsPerRow + word.x] = next;
+};
+
+
+#shader vertex
+#version 430 core
+
+void main()
+{
+    // Vertices 0, 1 and 2 make a triangle twice the size of the viewport, which covers all of it.
+    const vec2 corner = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);
+};
+
+
+#shader fragment
+#version 430 core
+
+layout(std430, binding = 0) readonly buffer Cells
+{
+    uint cells[];
+};
+
+uniform ivec2 u_GridSize;
+uniform int u_WordsPerRow;
+uniform vec2 u_ViewportSize;
+
+out vec4 fragmentColour;
+
+void main()
+{
+    // Row 0 of the grid is at the bottom of the window, as with the vertex renderer.
+    const ivec2 cell = min(ivec2(gl_FragCoord.xy / u_ViewportSize * vec2(u_GridSize)), u_GridSize - 1);
+    const uint word = cells[cell.y * u_WordsPerRow + (cell.x >> 5)];
+    const float state = float((word >> (cell.x & 31)) & 1u);
+    fragmentColour = vec4(vec3(state), 1.0);
+};
@@ -0,0 +1,131 @@
+#include "activetiles.hpp"
+
+#include "numa.hpp"
+#include "simdkernel.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <ostream>
+#include <utility>
+
+ActiveTileEngine::ActiveTileEngine(int width, int height, EdgeMode m_edgeMode, int nThreads, bool pinThreads, ThreadScaling threadScaling)
+    : grid(width, height, Allocation::UNTOUCHED)
+    , nextGrid(width, height, Allocation::UNTOUCHED)
+    , edgeMode(m_edgeMode)
+    , nTilesX((width + tileSize - 1) / tileSize)
+    , nTilesY((height + tileSize - 1) / tileSize)
+    , pool(nThreads, pinThreads)
+    , scheduler(pool)
+    , threadCount(Name(), pool.ThreadCount(), threadScaling)
+{
+    // The scheduler hands each worker an equal run of tiles in row-major order before any stealing, which is
+    // roughly the same band of rows that worker first touches.
+    FirstTouchBands(pool, grid);
+    FirstTouchBands(pool, nextGrid);
+
+    changed.assign(static_cast<size_t>(nTilesX) * nTilesY, 1);
+    nextChanged.assign(changed.size(), 0);
+    activeTiles.reserve(changed.size());
+}
+
+void ActiveTileEngine::Load(const CellGrid& source)
+{
+    CopyBands(pool, source, grid);
+
+    // Everything has to be computed at least once before the tiles can be trusted.
+    std::fill(changed.begin(), changed.end(), 1);
+}
+
+void ActiveTileEngine::Store(CellGrid& destination) const
+{
+    std::copy(grid.cells.begin(), grid.cells.end(), destination.cells.begin());
+}
+
+bool ActiveTileEngine::NeighbourhoodChanged(int tileX, int tileY) const
+{
+    // Only a toroidal grid has neighbours across its edges. Mirrored edges reflect the tile's own cells.
+    const bool wraps = edgeMode == EdgeMode::TOROIDAL;
+
+    for (int dy = -1; dy <= 1; ++dy) {
+        for (int dx = -1; dx <= 1; ++dx) {
+            int x = tileX + dx;
+            int y = tileY + dy;
+
+            if (wraps) {
+                x = (x + nTilesX) % nTilesX;
+                y = (y + nTilesY) % nTilesY;
+            } else if (x < 0 || y < 0 || x >= nTilesX || y >= nTilesY) {
+                continue;
+            }
+
+            if (changed[(static_cast<size_t>(y) * nTilesX) + x]) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+void ActiveTileEngine::StepTile(uint32_t tile)
+{
+    const int tileX = static_cast<int>(tile % nTilesX);
+    const int tileY = static_cast<int>(tile / nTilesX);
+
+    const int xBegin = tileX * tileSize;
+    const int xEnd = std::min(xBegin + tileSize, grid.width);
+    const int yBegin = tileY * tileSize;
+    const int yEnd = std::min(yBegin + tileSize, grid.height);
+
+    StepBlock(grid, nextGrid, xBegin, xEnd, yBegin, yEnd);
+
+    // Each tile only writes its own cells and its own flag, so tiles can be stepped in any order on any thread.
+    for (int y = yBegin; y < yEnd && !nextChanged[tile]; ++y) {
+        nextChanged[tile] = std::memcmp(Row(grid, y) + xBegin, Row(nextGrid, y) + xBegin, xEnd - xBegin) != 0;
+    }
+}
+
+void ActiveTileEngine::Step()
+{
+    RefreshHalo(grid, edgeMode);
+
+    activeTiles.clear();
+    for (int tileY = 0; tileY < nTilesY; ++tileY) {
+        for (int tileX = 0; tileX < nTilesX; ++tileX) {
+            const uint32_t tile = static_cast<uint32_t>((tileY * nTilesX) + tileX);
+            nextChanged[tile] = 0;
+
+            if (NeighbourhoodChanged(tileX, tileY)) {
+                activeTiles.push_back(tile);
+            }
+        }
+    }
+
+    // Only the active tiles cost anything, so a settled soup steps on few threads, or just one.
+    const int nThreads = threadCount.Choose(activeTiles.size());
+    auto stepTile = [this](int, uint32_t index) { StepTile(activeTiles[index]); };
+    scheduler.Run(static_cast<uint32_t>(activeTiles.size()), stepTile, nThreads);
+    threadCount.Record(activeTiles.size(), pool.LastRun());
+
+    nActiveTiles = static_cast<int>(activeTiles.size());
+    nActiveTilesTotal += nActiveTiles;
+    ++nSteps;
+
+    std::swap(grid, nextGrid);
+    std::swap(changed, nextChanged);
+}
+
+void ActiveTileEngine::ReportStatistics(std::ostream& stream) const
+{
+    const double averageActiveTiles = nSteps == 0 ? 0.0 : static_cast<double>(nActiveTilesTotal) / nSteps;
+
+    stream << "tiled: " << nActiveTiles << " of " << TileCount() << " tiles active in the last generation, "
+           << averageActiveTiles << " on average over " << nSteps << " generations\n";
+    scheduler.ReportStatistics(stream);
+    threadCount.ReportStatistics(stream);
+}
+
+void ActiveTileEngine::ReportMemoryPlacement(std::ostream& stream) const
+{
+    ReportBandNodes(stream, grid, pool.ThreadCount());
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "cellgrid.hpp"
+#include "engine.hpp"
+#include "threadcontroller.hpp"
+#include "threadpool.hpp"
+#include "workstealing.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// ------------------
+// Active Tiles
+// ------------------
+
+// Splits the grid into square tiles and only recomputes the tiles that changed in the last generation,
+// or that border one which did. Still lifes and empty space cost nothing once a soup has settled.
+// The active tiles are stepped as separate tasks on a work-stealing scheduler, since they bunch up wherever the soup is still busy.
+class ActiveTileEngine : public Engine {
+public:
+    static constexpr int tileSize = 32;
+
+    ActiveTileEngine(int width, int height, EdgeMode edgeMode, int nThreads, bool pinThreads, ThreadScaling threadScaling);
+
+    std::string_view Name() const override { return "tiled"; }
+    void Load(const CellGrid& source) override;
+    void Store(CellGrid& destination) const override;
+    void Step() override;
+    void ReportStatistics(std::ostream& stream) const override;
+    void ReportMemoryPlacement(std::ostream& stream) const override;
+    bool SupportsEdgeMode(EdgeMode) const override { return true; }
+
+    // Number of tiles recomputed by the last Step().
+    int ActiveTileCount() const { return nActiveTiles; }
+    int TileCount() const { return nTilesX * nTilesY; }
+
+private:
+    CellGrid grid;
+    CellGrid nextGrid;
+    EdgeMode edgeMode = EdgeMode::DEAD;
+
+    int nTilesX = 0;
+    int nTilesY = 0;
+
+    // Whether each tile changed in the last generation, and the same for the generation being computed.
+    // A tile that didn't change holds the same cells in both grids, so skipping it needs no copy.
+    std::vector<uint8_t> changed;
+    std::vector<uint8_t> nextChanged;
+
+    // Indices of the tiles to step this generation, in row-major order.
+    std::vector<uint32_t> activeTiles;
+
+    ThreadPool pool;
+    WorkStealingScheduler scheduler;
+    ThreadCountController threadCount;
+
+    int nActiveTiles = 0;
+    uint64_t nActiveTilesTotal = 0;
+    uint64_t nSteps = 0;
+
+    bool NeighbourhoodChanged(int tileX, int tileY) const;
+    void StepTile(uint32_t tile);
+};
@@ -0,0 +1,79 @@
+#include "allocationcounter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+namespace {
+    std::atomic<uint64_t> nAllocations = 0;
+}
+
+uint64_t AllocationCount()
+{
+    return nAllocations.load(std::memory_order_relaxed);
+}
+
+void AssertNoAllocationsSince(uint64_t allocationCount, std::string_view where)
+{
+    if constexpr (allocationCountingEnabled) {
+        const uint64_t nNewAllocations = AllocationCount() - allocationCount;
+
+        if (nNewAllocations != 0) {
+            std::cout << "Error: " << nNewAllocations << " heap allocation(s) in " << where << ", which must not allocate!" << std::endl;
+            std::abort();
+        }
+    }
+}
+
+#ifndef NDEBUG
+
+// The array and nothrow forms of operator new and delete forward to these. Over-aligned types get the aligned forms
+// below, which the standard library implements without going through these, so those are replaced too.
+void* operator new(std::size_t size)
+{
+    nAllocations.fetch_add(1, std::memory_order_relaxed);
+
+    // malloc(0) may return nullptr, which operator new must not.
+    if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    nAllocations.fetch_add(1, std::memory_order_relaxed);
+
+    // aligned_alloc() needs a size that is a multiple of the alignment.
+    const std::size_t alignmentBytes = static_cast<std::size_t>(alignment);
+    const std::size_t alignedSize = ((size == 0 ? 1 : size) + alignmentBytes - 1) / alignmentBytes * alignmentBytes;
+    if (void* pointer = std::aligned_alloc(alignmentBytes, alignedSize)) {
+        return pointer;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+#endif
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+// ------------------
+// Allocation Counting
+// ------------------
+
+// Debug builds replace the global operator new to count heap allocations, so that the steady-state
+// simulation and render loop can be checked to never touch the heap.
+#ifndef NDEBUG
+constexpr bool allocationCountingEnabled = true;
+#else
+constexpr bool allocationCountingEnabled = false;
+#endif
+
+// Number of calls to the global operator new so far. Always 0 when allocation counting is disabled.
+uint64_t AllocationCount();
+
+// Aborts if any heap allocation happened since AllocationCount() returned allocationCount.
+// where describes the checked code for the error message.
+void AssertNoAllocationsSince(uint64_t allocationCount, std::string_view where);
@@ -0,0 +1,78 @@
+#include "bitboard.hpp"
+
+#include <utility>
+
+namespace {
+    // Evaluate B3/S23 for the 64 cells in the middle word of three rows.
+    inline uint64_t StepWord(const uint64_t* above, const uint64_t* middle, const uint64_t* below, int w, int wordsPerRow)
+    {
+        const bool hasPrevious = w > 0;
+        const bool hasNext = w + 1 < wordsPerRow;
+
+        return StepBitWord(hasPrevious ? above[w - 1] : 0, above[w], hasNext ? above[w + 1] : 0,
+            hasPrevious ? middle[w - 1] : 0, middle[w], hasNext ? middle[w + 1] : 0,
+            hasPrevious ? below[w - 1] : 0, below[w], hasNext ? below[w + 1] : 0);
+    }
+}
+
+BitboardEngine::BitboardEngine(int m_width, int m_height)
+    : width(m_width)
+    , height(m_height)
+    , wordsPerRow((m_width + bitsPerWord - 1) / bitsPerWord)
+{
+    const int nTrailingBits = width % bitsPerWord;
+    lastWordMask = nTrailingBits == 0 ? ~uint64_t(0) : (uint64_t(1) << nTrailingBits) - 1;
+
+    const size_t nWords = static_cast<size_t>(height + 2) * wordsPerRow;
+    rows.assign(nWords, 0);
+    nextRows.assign(nWords, 0);
+}
+
+void BitboardEngine::Load(const CellGrid& grid)
+{
+    for (int y = 0; y < height; ++y) {
+        uint64_t* row = Row(rows, y);
+
+        for (int w = 0; w < wordsPerRow; ++w) {
+            uint64_t word = 0;
+            for (int n = 0; n < bitsPerWord; ++n) {
+                const int x = (w * bitsPerWord) + n;
+                if (GetCellState(grid, x, y) == State::ALIVE) {
+                    word |= uint64_t(1) << n;
+                }
+            }
+            row[w] = word;
+        }
+    }
+}
+
+void BitboardEngine::Store(CellGrid& grid) const
+{
+    for (int y = 0; y < height; ++y) {
+        const uint64_t* row = Row(rows, y);
+
+        for (int x = 0; x < width; ++x) {
+            const uint64_t word = row[x / bitsPerWord];
+            SetCellState(grid, x, y, static_cast<State>((word >> (x % bitsPerWord)) & 1));
+        }
+    }
+}
+
+void BitboardEngine::Step()
+{
+    for (int y = 0; y < height; ++y) {
+        const uint64_t* above = Row(rows, y - 1);
+        const uint64_t* middle = Row(rows, y);
+        const uint64_t* below = Row(rows, y + 1);
+        uint64_t* next = Row(nextRows, y);
+
+        for (int w = 0; w < wordsPerRow; ++w) {
+            next[w] = StepWord(above, middle, below, w, wordsPerRow);
+        }
+
+        // Cells past the right edge of the grid must stay dead.
+        next[wordsPerRow - 1] &= lastWordMask;
+    }
+
+    std::swap(rows, nextRows);
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "cellgrid.hpp"
+#include "engine.hpp"
+
+#include <cstdint>
+#include <vector>
+
+constexpr int bitsPerWord = 64;
+
+// Shift a row so that each bit lines up with its west (x - 1) or east (x + 1) neighbour.
+// previous and next are the words either side of word, or 0 past the edges of the grid.
+inline uint64_t WestNeighbours(uint64_t previous, uint64_t word) { return (word << 1) | (previous >> (bitsPerWord - 1)); }
+inline uint64_t EastNeighbours(uint64_t word, uint64_t next) { return (word >> 1) | (next << (bitsPerWord - 1)); }
+
+// Evaluate B3/S23 for 64 independent cells at once, using full-adder logic on whole words.
+// Bit n of each argument is the corresponding neighbour of the cell in bit n of middle.
+inline uint64_t StepBitSlices(uint64_t aboveWest, uint64_t above, uint64_t aboveEast,
+    uint64_t middleWest, uint64_t middle, uint64_t middleEast,
+    uint64_t belowWest, uint64_t below, uint64_t belowEast)
+{
+    // Full adders over each row of neighbours. The "ones" bits have weight 1 and the "twos" bits weight 2.
+    const uint64_t aboveOnes = aboveWest ^ above ^ aboveEast;
+    const uint64_t aboveTwos = (aboveWest & above) | (aboveEast & (aboveWest ^ above));
+    const uint64_t middleOnes = middleWest ^ middleEast;
+    const uint64_t middleTwos = middleWest & middleEast;
+    const uint64_t belowOnes = belowWest ^ below ^ belowEast;
+    const uint64_t belowTwos = (belowWest & below) | (belowEast & (belowWest ^ below));
+
+    // Add the three weight 1 bits, carrying into weight 2.
+    const uint64_t ones = aboveOnes ^ middleOnes ^ belowOnes;
+    const uint64_t onesCarry = (aboveOnes & middleOnes) | (belowOnes & (aboveOnes ^ middleOnes));
+
+    // The neighbour count is ones + 2 * (number of weight 2 bits set).
+    // A count of 2 or 3 needs exactly one of the four weight 2 bits to be set.
+    const uint64_t pairA = aboveTwos ^ middleTwos;
+    const uint64_t pairB = belowTwos ^ onesCarry;
+    const uint64_t exactlyOneTwo = (pairA ^ pairB) & ~(aboveTwos & middleTwos) & ~(belowTwos & onesCarry);
+
+    // Count of 3 gives birth or survival, count of 2 only lets a live cell survive.
+    return exactlyOneTwo & (ones | middle);
+}
+
+// Evaluate B3/S23 for the 64 cells in the word middle, by shifting each row so that neighbours line up.
+// Each row of neighbours is given as the word in line with middle, and the words before (lower x) and after it.
+inline uint64_t StepBitWord(uint64_t abovePrevious, uint64_t above, uint64_t aboveNext,
+    uint64_t middlePrevious, uint64_t middle, uint64_t middleNext,
+    uint64_t belowPrevious, uint64_t below, uint64_t belowNext)
+{
+    return StepBitSlices(WestNeighbours(abovePrevious, above), above, EastNeighbours(above, aboveNext),
+        WestNeighbours(middlePrevious, middle), middle, EastNeighbours(middle, middleNext),
+        WestNeighbours(belowPrevious, below), below, EastNeighbours(below, belowNext));
+}
+
+// Stores 64 cells per word and evaluates B3/S23 for a whole word at a time using full-adder logic.
+// Bit n of word w in a row holds the cell at x = (w * 64) + n.
+class BitboardEngine : public Engine {
+public:
+    BitboardEngine(int width, int height);
+
+    std::string_view Name() const override { return "bitboard"; }
+    void Load(const CellGrid& grid) override;
+    void Store(CellGrid& grid) const override;
+    void Step() override;
+
+private:
+    int width = 0;
+    int height = 0;
+    int wordsPerRow = 0;
+
+    // Mask of the cells in the last word of a row that lie inside the grid.
+    uint64_t lastWordMask = 0;
+
+    // Rows are padded with an empty row above and below the grid so that neighbour reads need no bounds checks.
+    std::vector<uint64_t> rows;
+    std::vector<uint64_t> nextRows;
+
+    uint64_t* Row(std::vector<uint64_t>& buffer, int y) { return buffer.data() + (static_cast<size_t>(y + 1) * wordsPerRow); }
+    const uint64_t* Row(const std::vector<uint64_t>& buffer, int y) const { return buffer.data() + (static_cast<size_t>(y + 1) * wordsPerRow); }
+};
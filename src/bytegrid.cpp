@@ -0,0 +1,64 @@
+#include "bytegrid.hpp"
+
+#include "numa.hpp"
+#include "simdkernel.hpp"
+
+#include <algorithm>
+#include <utility>
+
+void GameOfLife(const CellGrid& current, CellGrid& next)
+{
+    // Rows are summed with the widest vector instructions the CPU supports.
+    StepRows(current, next, 0, current.height);
+}
+
+ByteGridEngine::ByteGridEngine(int width, int height, EdgeMode m_edgeMode, int nThreads, bool pinThreads, ThreadScaling threadScaling)
+    : grid(width, height, Allocation::UNTOUCHED)
+    , nextGrid(width, height, Allocation::UNTOUCHED)
+    , edgeMode(m_edgeMode)
+    , pool(nThreads, pinThreads)
+    , threadCount(Name(), pool.ThreadCount(), threadScaling)
+{
+    FirstTouchBands(pool, grid);
+    FirstTouchBands(pool, nextGrid);
+}
+
+void ByteGridEngine::Load(const CellGrid& source)
+{
+    CopyBands(pool, source, grid);
+}
+
+void ByteGridEngine::Store(CellGrid& destination) const
+{
+    std::copy(grid.cells.begin(), grid.cells.end(), destination.cells.begin());
+}
+
+void ByteGridEngine::Step()
+{
+    RefreshHalo(grid, edgeMode);
+
+    // Every cell costs the same whatever it holds, so the work is the whole grid.
+    const uint64_t nCells = static_cast<uint64_t>(grid.width) * static_cast<uint64_t>(grid.height);
+    const int nThreads = threadCount.Choose(nCells);
+
+    auto stepBand = [this, nThreads](int thread) {
+        const Band band = BandOf(grid.height, thread, nThreads);
+        StepRows(grid, nextGrid, band.begin, band.end);
+    };
+    pool.Run(stepBand, nThreads);
+    threadCount.Record(nCells, pool.LastRun());
+
+    // The next generation becomes the current one, and the old one is overwritten next step.
+    std::swap(grid, nextGrid);
+}
+
+void ByteGridEngine::ReportStatistics(std::ostream& stream) const
+{
+    pool.ReportStatistics(stream);
+    threadCount.ReportStatistics(stream);
+}
+
+void ByteGridEngine::ReportMemoryPlacement(std::ostream& stream) const
+{
+    ReportBandNodes(stream, grid, pool.ThreadCount());
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "cellgrid.hpp"
+#include "engine.hpp"
+#include "threadcontroller.hpp"
+#include "threadpool.hpp"
+
+// Write the generation after current into next. Both grids must have the same dimensions,
+// and current's halo must be up to date.
+void GameOfLife(const CellGrid& current, CellGrid& next);
+
+// Reference engine which steps a CellGrid directly.
+// The two grids are allocated once and swapped every generation. Each generation is split into one band of rows
+// per thread; every cell is computed the same way whichever band it falls in, so the result doesn't depend on nThreads.
+// Each thread also first touches its band, so on NUMA machines the band is on the node of the thread that steps it.
+class ByteGridEngine : public Engine {
+public:
+    ByteGridEngine(int width, int height, EdgeMode edgeMode, int nThreads, bool pinThreads, ThreadScaling threadScaling);
+
+    std::string_view Name() const override { return "bytegrid"; }
+    void Load(const CellGrid& source) override;
+    void Store(CellGrid& destination) const override;
+    void Step() override;
+    bool SupportsEdgeMode(EdgeMode) const override { return true; }
+    void ReportStatistics(std::ostream& stream) const override;
+    void ReportMemoryPlacement(std::ostream& stream) const override;
+
+private:
+    CellGrid grid;
+    CellGrid nextGrid;
+    EdgeMode edgeMode = EdgeMode::DEAD;
+    ThreadPool pool;
+    ThreadCountController threadCount;
+};
@@ -0,0 +1,100 @@
+#include "cellgrid.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace {
+    constexpr std::array<std::string_view, 3> edgeModeNames = { "dead", "toroidal", "mirror" };
+}
+
+State GetCellState(const CellGrid& grid, int x, int y)
+{
+    if (x < 0 || y < 0 || x >= grid.width || y >= grid.height) {
+        return State::DEAD;
+    }
+
+    return static_cast<State>(Row(grid, y)[x]);
+}
+
+void SetCellState(CellGrid& grid, int x, int y, State state)
+{
+    if (x < 0 || y < 0 || x >= grid.width || y >= grid.height) {
+        return;
+    }
+
+    Row(grid, y)[x] = static_cast<uint8_t>(state);
+}
+
+uint64_t CountAliveCells(const CellGrid& grid)
+{
+    uint64_t nAliveCells = 0;
+    for (int y = 0; y < grid.height; ++y) {
+        const uint8_t* row = Row(grid, y);
+        for (int x = 0; x < grid.width; ++x) {
+            nAliveCells += row[x];
+        }
+    }
+
+    return nAliveCells;
+}
+
+void RefreshHalo(CellGrid& grid, EdgeMode edgeMode)
+{
+    const int width = grid.width;
+    const int height = grid.height;
+
+    // Columns first, then whole rows including their halo columns, which fills in the corners.
+    for (int y = 0; y < height; ++y) {
+        uint8_t* row = Row(grid, y);
+
+        switch (edgeMode) {
+        case EdgeMode::DEAD:
+            row[-1] = 0;
+            row[width] = 0;
+            break;
+        case EdgeMode::TOROIDAL:
+            row[-1] = row[width - 1];
+            row[width] = row[0];
+            break;
+        case EdgeMode::MIRROR:
+            row[-1] = row[0];
+            row[width] = row[width - 1];
+            break;
+        }
+    }
+
+    uint8_t* top = Row(grid, -1) - 1;
+    uint8_t* bottom = Row(grid, height) - 1;
+
+    switch (edgeMode) {
+    case EdgeMode::DEAD:
+        std::fill_n(top, grid.stride, 0);
+        std::fill_n(bottom, grid.stride, 0);
+        break;
+    case EdgeMode::TOROIDAL:
+        std::copy_n(Row(grid, height - 1) - 1, grid.stride, top);
+        std::copy_n(Row(grid, 0) - 1, grid.stride, bottom);
+        break;
+    case EdgeMode::MIRROR:
+        std::copy_n(Row(grid, 0) - 1, grid.stride, top);
+        std::copy_n(Row(grid, height - 1) - 1, grid.stride, bottom);
+        break;
+    }
+}
+
+std::string_view EdgeModeName(EdgeMode edgeMode)
+{
+    return edgeModeNames[static_cast<int>(edgeMode)];
+}
+
+bool ParseEdgeMode(std::string_view name, EdgeMode& edgeMode)
+{
+    for (size_t index = 0; index < edgeModeNames.size(); ++index) {
+        if (name == edgeModeNames[index]) {
+            edgeMode = static_cast<EdgeMode>(index);
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// ------------------
+// Cell Grid
+// ------------------
+
+enum class State {
+    DEAD = 0,
+    ALIVE = 1
+};
+
+// What lies past the edges of the grid.
+enum class EdgeMode {
+    DEAD = 0, // Cells past the edges are always dead.
+    TOROIDAL = 1, // The grid wraps around, so the left edge neighbours the right and the top the bottom.
+    MIRROR = 2 // The edge cells are reflected, so a cell past an edge has the state of the edge cell next to it.
+};
+
+// Allocator whose elements are left uninitialised when a container is sized without a value, instead of being zeroed.
+// Memory isn't placed on a NUMA node until it is first written, so this lets each thread place its own part of a buffer.
+template <typename T>
+struct DefaultInitAllocator : std::allocator<T> {
+    template <typename U>
+    struct rebind {
+        using other = DefaultInitAllocator<U>;
+    };
+
+    DefaultInitAllocator() = default;
+    template <typename U>
+    DefaultInitAllocator(const DefaultInitAllocator<U>&) noexcept {}
+
+    template <typename U>
+    void construct(U* pointer) noexcept
+    {
+        ::new (static_cast<void*>(pointer)) U;
+    }
+
+    template <typename U, typename... Args>
+    void construct(U* pointer, Args&&... args)
+    {
+        ::new (static_cast<void*>(pointer)) U(std::forward<Args>(args)...);
+    }
+};
+
+// Whether a new grid's cells are zeroed, or left for the threads that will use them to write first.
+enum class Allocation {
+    ZEROED = 0,
+    UNTOUCHED = 1
+};
+
+// Dense simulation state with one byte per cell, stored row-major.
+// This is the source of truth for the Game of Life; render vertices are derived from it when a frame is drawn.
+// The cells are surrounded by a one cell wide halo of ghost cells, so that every cell has eight neighbours to read
+// without bounds checks. RefreshHalo() fills the halo in according to the edge mode.
+struct CellGrid {
+    int width = 0;
+    int height = 0;
+
+    // Bytes from one row to the next, including the halo on either side.
+    int stride = 0;
+    std::vector<uint8_t, DefaultInitAllocator<uint8_t>> cells;
+
+    CellGrid() = default;
+    CellGrid(int m_width, int m_height, Allocation allocation = Allocation::ZEROED)
+        : width(m_width)
+        , height(m_height)
+        , stride(m_width + 2)
+    {
+        const size_t nCells = static_cast<size_t>(m_width + 2) * static_cast<size_t>(m_height + 2);
+        if (allocation == Allocation::ZEROED) {
+            cells.assign(nCells, 0);
+        } else {
+            cells.resize(nCells);
+        }
+    }
+};
+
+// Pointer to the cell at x = 0 of row y. Rows -1 and height are the halo, as are columns -1 and width of every row.
+inline uint8_t* Row(CellGrid& grid, int y)
+{
+    return &grid.cells[(static_cast<size_t>(y + 1) * grid.stride) + 1];
+}
+
+inline const uint8_t* Row(const CellGrid& grid, int y)
+{
+    return &grid.cells[(static_cast<size_t>(y + 1) * grid.stride) + 1];
+}
+
+// Cells outside of the grid are always dead, whatever the halo holds.
+State GetCellState(const CellGrid& grid, int x, int y);
+void SetCellState(CellGrid& grid, int x, int y, State state);
+
+uint64_t CountAliveCells(const CellGrid& grid);
+
+// Fill the halo in from the grid's cells. Must be called after the cells change, and before they are stepped.
+void RefreshHalo(CellGrid& grid, EdgeMode edgeMode);
+
+std::string_view EdgeModeName(EdgeMode edgeMode);
+
+// Returns false if name isn't the name of an edge mode.
+bool ParseEdgeMode(std::string_view name, EdgeMode& edgeMode);
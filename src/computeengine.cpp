@@ -0,0 +1,134 @@
+#include "computeengine.hpp"
+
+#include "shader.hpp"
+
+#include <GL/glew.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <utility>
+
+namespace {
+    const std::string computeShaderPath = "../compute.glsl";
+
+    // Binding points of the current and next generations' buffers, as declared in the shaders.
+    constexpr uint32_t currentBinding = 0;
+    constexpr uint32_t nextBinding = 1;
+}
+
+ComputeEngine::ComputeEngine(int m_width, int m_height, EdgeMode m_edgeMode)
+    : width(m_width)
+    , height(m_height)
+    , edgeMode(m_edgeMode)
+    , staging(static_cast<size_t>(m_width) * static_cast<size_t>(m_height))
+{
+    if (!ContextVersionAtLeast(4, 3)) {
+        std::cout << "Error: The compute engine needs OpenGL 4.3 for compute shaders, but the context is " << glGetString(GL_VERSION) << "\n";
+        exit(EXIT_FAILURE);
+    }
+
+    // Each buffer is a single storage block, whose size the driver limits.
+    const GLsizeiptr nBufferBytes = static_cast<GLsizeiptr>(staging.size() * sizeof(uint32_t));
+    GLint64 maxBlockBytes = 0;
+    glGetInteger64v(GL_MAX_SHADER_STORAGE_BLOCK_SIZE, &maxBlockBytes);
+    if (nBufferBytes > maxBlockBytes) {
+        std::cout << "Error: A " << width << "x" << height << " grid needs " << nBufferBytes / (1024 * 1024) << " MiB storage buffers, but this driver allows "
+                  << maxBlockBytes / (1024 * 1024) << " MiB. Use a smaller grid.\n";
+        exit(EXIT_FAILURE);
+    }
+
+    ShaderProgramSource source = ParseShader(computeShaderPath);
+    stepProgram = CreateComputeShader(source);
+    drawProgram = CreateShader(source);
+
+    // Core profiles can't draw without a vertex array, even though the full-screen triangle has no attributes.
+    glGenVertexArrays(1, &emptyVAO);
+
+    glGenBuffers(static_cast<GLsizei>(buffers.size()), buffers.data());
+    for (const uint32_t buffer : buffers) {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, nBufferBytes, nullptr, GL_DYNAMIC_COPY);
+    }
+}
+
+ComputeEngine::~ComputeEngine()
+{
+    glDeleteBuffers(static_cast<GLsizei>(buffers.size()), buffers.data());
+    glDeleteVertexArrays(1, &emptyVAO);
+    glDeleteProgram(stepProgram);
+    glDeleteProgram(drawProgram);
+}
+
+void ComputeEngine::Load(const CellGrid& grid)
+{
+    for (int y = 0; y < height; ++y) {
+        const uint8_t* row = Row(grid, y);
+        for (int x = 0; x < width; ++x) {
+            staging[(static_cast<size_t>(y) * width) + x] = row[x];
+        }
+    }
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffers[current]);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, static_cast<GLsizeiptr>(staging.size() * sizeof(uint32_t)), staging.data());
+}
+
+void ComputeEngine::Store(CellGrid& grid) const
+{
+    // Waits for the steps queued so far.
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffers[current]);
+    glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, static_cast<GLsizeiptr>(staging.size() * sizeof(uint32_t)), staging.data());
+
+    for (int y = 0; y < height; ++y) {
+        uint8_t* row = Row(grid, y);
+        for (int x = 0; x < width; ++x) {
+            row[x] = static_cast<uint8_t>(staging[(static_cast<size_t>(y) * width) + x]);
+        }
+    }
+}
+
+void ComputeEngine::Step()
+{
+    glUseProgram(stepProgram);
+    glUniform2i(glGetUniformLocation(stepProgram, "u_GridSize"), width, height);
+    glUniform1i(glGetUniformLocation(stepProgram, "u_EdgeMode"), static_cast<int>(edgeMode));
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, currentBinding, buffers[current]);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, nextBinding, buffers[1 - current]);
+
+    const GLuint nGroupsX = static_cast<GLuint>((width + workgroupSize - 1) / workgroupSize);
+    const GLuint nGroupsY = static_cast<GLuint>((height + workgroupSize - 1) / workgroupSize);
+    glDispatchCompute(nGroupsX, nGroupsY, 1);
+
+    // The next step, and drawing, read what this one wrote.
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    current = 1 - current;
+    ++nSteps;
+}
+
+void ComputeEngine::WaitForSteps()
+{
+    glFinish();
+}
+
+void ComputeEngine::Draw(int viewportWidth, int viewportHeight)
+{
+    glUseProgram(drawProgram);
+    glUniform2i(glGetUniformLocation(drawProgram, "u_GridSize"), width, height);
+    glUniform2f(glGetUniformLocation(drawProgram, "u_ViewportSize"), static_cast<float>(viewportWidth), static_cast<float>(viewportHeight));
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, currentBinding, buffers[current]);
+
+    // A single triangle, positioned by the vertex shader, covers the viewport.
+    constexpr int nVertices = 3;
+    glBindVertexArray(emptyVAO);
+    glDrawArrays(GL_TRIANGLES, 0, nVertices);
+}
+
+void ComputeEngine::ReportStatistics(std::ostream& stream) const
+{
+    const size_t nBufferBytes = staging.size() * sizeof(uint32_t);
+
+    stream << "compute: " << nSteps << " generations in " << (width + workgroupSize - 1) / workgroupSize << "x"
+           << (height + workgroupSize - 1) / workgroupSize << " workgroups, two " << nBufferBytes / 1024 << " KiB storage buffers\n";
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "cellgrid.hpp"
+#include "gpuengine.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// ------------------
+// Compute Shader Engine
+// ------------------
+
+// Steps the game in a compute shader over two shader storage buffers of one uint per cell, which swap roles every
+// generation. Drawing reads the current buffer from a fragment shader, so the cells never leave the GPU.
+// Needs OpenGL 4.3, which Mesa's llvmpipe provides on machines without a GPU.
+class ComputeEngine : public GpuEngine {
+public:
+    static constexpr int workgroupSize = 16;
+
+    ComputeEngine(int width, int height, EdgeMode edgeMode);
+    ~ComputeEngine() override;
+
+    ComputeEngine(const ComputeEngine&) = delete;
+    ComputeEngine& operator=(const ComputeEngine&) = delete;
+
+    std::string_view Name() const override { return "compute"; }
+    void Load(const CellGrid& grid) override;
+    void Store(CellGrid& grid) const override;
+    void Step() override;
+    void WaitForSteps() override;
+    bool SupportsEdgeMode(EdgeMode) const override { return true; }
+    void ReportStatistics(std::ostream& stream) const override;
+    void Draw(int viewportWidth, int viewportHeight) override;
+
+private:
+    int width = 0;
+    int height = 0;
+    EdgeMode edgeMode = EdgeMode::DEAD;
+
+    uint32_t stepProgram = 0;
+    uint32_t drawProgram = 0;
+    uint32_t emptyVAO = 0;
+
+    // buffers[current] holds the current generation.
+    std::array<uint32_t, 2> buffers = { 0, 0 };
+    int current = 0;
+
+    // Cells on their way to or from the GPU, one uint each.
+    mutable std::vector<uint32_t> staging;
+
+    uint64_t nSteps = 0;
+};
@@ -0,0 +1,97 @@
+#include "engine.hpp"
+
+#include "activetiles.hpp"
+#include "bitboard.hpp"
+#include "bytegrid.hpp"
+#include "computeengine.hpp"
+#include "fragmentengine.hpp"
+#include "hashlife.hpp"
+#include "lookuptable.hpp"
+#include "multiuniverse.hpp"
+#include "packedcompute.hpp"
+#include "processdomain.hpp"
+#include "sparsechunks.hpp"
+#include "temporalblocking.hpp"
+
+#include <random>
+
+bool EngineNeedsOpenGL(const Options& options)
+{
+    return options.engine == "compute" || options.engine == "packed" || options.engine == "fragment";
+}
+
+std::unique_ptr<Engine> CreateEngine(const Options& options, int width, int height)
+{
+    const std::string_view name = options.engine;
+
+    if (name == "bytegrid") {
+        return std::make_unique<ByteGridEngine>(width, height, options.edgeMode, options.threads, options.pinThreads, options.threadScaling);
+    } else if (name == "bitboard") {
+        return std::make_unique<BitboardEngine>(width, height);
+    } else if (name == "lookup") {
+        return std::make_unique<LookupTableEngine>(width, height);
+    } else if (name == "tiled") {
+        return std::make_unique<ActiveTileEngine>(width, height, options.edgeMode, options.threads, options.pinThreads, options.threadScaling);
+    } else if (name == "temporal") {
+        return std::make_unique<TemporalBlockingEngine>(width, height, options.temporalDepth, options.threads, options.pinThreads);
+    } else if (name == "universes") {
+        // Without a seed, each run gets different soups.
+        const uint64_t seed = options.soupSeed ? *options.soupSeed : (static_cast<uint64_t>(std::random_device {}()) << 32) | std::random_device {}();
+        return std::make_unique<MultiUniverseEngine>(width, height, options.maxSoupAge, seed);
+    } else if (name == "processes") {
+        return std::make_unique<ProcessDomainEngine>(width, height, options.edgeMode, options.processes);
+    } else if (name == "compute") {
+        return std::make_unique<ComputeEngine>(width, height, options.edgeMode);
+    } else if (name == "packed") {
+        return std::make_unique<PackedComputeEngine>(width, height, options.edgeMode);
+    } else if (name == "fragment") {
+        return std::make_unique<FragmentShaderEngine>(width, height, options.edgeMode);
+    } else if (name == "sparse") {
+        return std::make_unique<SparseChunkEngine>(width, height);
+    } else if (name == "hashlife") {
+        constexpr size_t bytesPerMiB = 1024 * 1024;
+        return std::make_unique<HashLifeEngine>(width, height, options.hashLifeStepLog, options.hashLifeMemoryMiB * bytesPerMiB);
+    }
+
+    return nullptr;
+}
+
+uint64_t EstimateEngineMemory(const Options& options, int width, int height)
+{
+    const std::string_view name = options.engine;
+    const uint64_t nCells = static_cast<uint64_t>(width + 2) * static_cast<uint64_t>(height + 2);
+
+    if (name == "bitboard") {
+        // Two generations of one bit per cell.
+        return nCells / 4;
+    } else if (name == "hashlife") {
+        constexpr uint64_t bytesPerMiB = 1024 * 1024;
+        return options.hashLifeMemoryMiB * bytesPerMiB;
+    } else if (name == "universes") {
+        // Two generations of a 64 bit word per cell.
+        return 2 * sizeof(uint64_t) * nCells;
+    } else if (name == "sparse") {
+        return 0;
+    } else if (name == "processes") {
+        // Two generations of each worker's band, and the shared memory each band is loaded and stored through.
+        return (2 * nCells) + (static_cast<uint64_t>(width) * static_cast<uint64_t>(height));
+    } else if (name == "compute") {
+        // The generations are in GPU memory; only the staging copy of one uint per cell is on the host.
+        return sizeof(uint32_t) * static_cast<uint64_t>(width) * static_cast<uint64_t>(height);
+    } else if (name == "packed") {
+        // The staging copy of a bit per cell.
+        constexpr uint64_t cellsPerWord = 32;
+        return sizeof(uint32_t) * ((static_cast<uint64_t>(width) + cellsPerWord - 1) / cellsPerWord) * static_cast<uint64_t>(height);
+    } else if (name == "fragment") {
+        // Both generations are textures in GPU memory, and cells are copied straight to and from a CellGrid.
+        return 0;
+    }
+
+    // Two generations of one byte per cell, including the halo.
+    return 2 * nCells;
+}
+
+std::string_view EngineNames()
+{
+    return "bytegrid bitboard lookup tiled temporal universes processes compute packed fragment sparse hashlife";
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "cellgrid.hpp"
+#include "options.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string_view>
+
+// ------------------
+// Simulation Engines
+// ------------------
+
+// Common interface for the different ways of stepping the Game of Life.
+// Each engine owns its own representation of the cells; a CellGrid is used to move cells in and out of it.
+class Engine {
+public:
+    virtual ~Engine() = default;
+
+    virtual std::string_view Name() const = 0;
+
+    // Replace the engine's cells with those of grid.
+    virtual void Load(const CellGrid& grid) = 0;
+
+    // Copy the engine's cells into grid, which must have the same dimensions as the engine.
+    virtual void Store(CellGrid& grid) const = 0;
+
+    // Advance the simulation by GenerationsPerStep() generations.
+    virtual void Step() = 0;
+
+    virtual uint64_t GenerationsPerStep() const { return 1; }
+
+    // Block until every step asked for so far has been done, for engines that only queue steps up, like those on the GPU.
+    virtual void WaitForSteps() {}
+
+    // Engines are expected to allocate everything they need up front, so that Step() never touches the heap,
+    // unless their data structures grow with the pattern.
+    virtual bool AllocatesInStep() const { return false; }
+
+    // Engines treat cells past the edges of the grid as dead unless they can handle other edge modes.
+    virtual bool SupportsEdgeMode(EdgeMode edgeMode) const { return edgeMode == EdgeMode::DEAD; }
+
+    // Print whatever the engine measures about its own work, if anything.
+    virtual void ReportStatistics(std::ostream&) const {}
+
+    // Print which NUMA nodes the engine's memory is on, for engines that place it per thread.
+    virtual void ReportMemoryPlacement(std::ostream& stream) const { stream << Name() << ": memory isn't placed per thread\n"; }
+};
+
+// Whether the engine named options.engine runs on the GPU, and so needs an OpenGL context before it is created.
+bool EngineNeedsOpenGL(const Options& options);
+
+// Returns nullptr if there is no engine called options.engine.
+std::unique_ptr<Engine> CreateEngine(const Options& options, int width, int height);
+
+// Approximate bytes of memory the engine named options.engine needs for a grid of this size,
+// not counting what engines which grow with the pattern allocate as it evolves.
+uint64_t EstimateEngineMemory(const Options& options, int width, int height);
+
+// Space separated list of the names accepted by CreateEngine().
+std::string_view EngineNames();
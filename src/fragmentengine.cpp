@@ -0,0 +1,165 @@
+#include "fragmentengine.hpp"
+
+#include "shader.hpp"
+
+#include <GL/glew.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace {
+    const std::string stepShaderPath = "../fragment.glsl";
+    const std::string drawShaderPath = "../celltexture.glsl";
+
+    // A single triangle, positioned by the vertex shader, covers the viewport.
+    constexpr int nVertices = 3;
+
+    // Texels past the edges of a texture come from its wrap mode. Mirroring repeats the edge texel first,
+    // which is what the mirror edge mode needs; the border colour is dead.
+    GLint WrapMode(EdgeMode edgeMode)
+    {
+        switch (edgeMode) {
+        case EdgeMode::TOROIDAL:
+            return GL_REPEAT;
+        case EdgeMode::MIRROR:
+            return GL_MIRRORED_REPEAT;
+        default:
+            return GL_CLAMP_TO_BORDER;
+        }
+    }
+
+    // Each row of a CellGrid is followed by the halo, so the rows are read and written stride bytes apart.
+    void SetRowLength(GLenum parameter, const CellGrid& grid)
+    {
+        glPixelStorei(parameter == GL_UNPACK_ROW_LENGTH ? GL_UNPACK_ALIGNMENT : GL_PACK_ALIGNMENT, 1);
+        glPixelStorei(parameter, grid.stride);
+    }
+
+    uint32_t CreateProgram(const std::string& path)
+    {
+        ShaderProgramSource source = ParseShader(path);
+        const uint32_t program = CreateShader(source);
+
+        int linked = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        if (linked == GL_FALSE) {
+            std::cout << "Error: Failed to link the shaders in " << path << "\n";
+            exit(EXIT_FAILURE);
+        }
+
+        return program;
+    }
+}
+
+FragmentShaderEngine::FragmentShaderEngine(int m_width, int m_height, EdgeMode edgeMode)
+    : width(m_width)
+    , height(m_height)
+{
+    GLint maxTextureSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+    if (width > maxTextureSize || height > maxTextureSize) {
+        std::cout << "Error: A " << width << "x" << height << " grid doesn't fit in a texture, which this driver limits to "
+                  << maxTextureSize << " texels a side. Use a smaller grid.\n";
+        exit(EXIT_FAILURE);
+    }
+
+    stepProgram = CreateProgram(stepShaderPath);
+    drawProgram = CreateProgram(drawShaderPath);
+
+    // Core profiles can't draw without a vertex array, even though the full-screen triangle has no attributes.
+    glGenVertexArrays(1, &emptyVAO);
+
+    // Cells are stored as 0 or 1, which an R8 texture reads back as 0 or 1/255.
+    constexpr GLfloat deadBorder[] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    glGenTextures(static_cast<GLsizei>(textures.size()), textures.data());
+    glGenFramebuffers(static_cast<GLsizei>(framebuffers.size()), framebuffers.data());
+    for (size_t i = 0; i < textures.size(); ++i) {
+        glBindTexture(GL_TEXTURE_2D, textures[i]);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, WrapMode(edgeMode));
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, WrapMode(edgeMode));
+        glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, deadBorder);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffers[i]);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textures[i], 0);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            std::cout << "Error: This driver can't render into R8 textures\n";
+            exit(EXIT_FAILURE);
+        }
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+FragmentShaderEngine::~FragmentShaderEngine()
+{
+    glDeleteFramebuffers(static_cast<GLsizei>(framebuffers.size()), framebuffers.data());
+    glDeleteTextures(static_cast<GLsizei>(textures.size()), textures.data());
+    glDeleteVertexArrays(1, &emptyVAO);
+    glDeleteProgram(stepProgram);
+    glDeleteProgram(drawProgram);
+}
+
+void FragmentShaderEngine::Load(const CellGrid& grid)
+{
+    SetRowLength(GL_UNPACK_ROW_LENGTH, grid);
+    glBindTexture(GL_TEXTURE_2D, textures[current]);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RED, GL_UNSIGNED_BYTE, Row(grid, 0));
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+}
+
+void FragmentShaderEngine::Store(CellGrid& grid) const
+{
+    SetRowLength(GL_PACK_ROW_LENGTH, grid);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffers[current]);
+    glReadPixels(0, 0, width, height, GL_RED, GL_UNSIGNED_BYTE, Row(grid, 0));
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+}
+
+void FragmentShaderEngine::Step()
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffers[1 - current]);
+    glViewport(0, 0, width, height);
+
+    glUseProgram(stepProgram);
+    glUniform2f(glGetUniformLocation(stepProgram, "u_GridSize"), static_cast<float>(width), static_cast<float>(height));
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, textures[current]);
+
+    glBindVertexArray(emptyVAO);
+    glDrawArrays(GL_TRIANGLES, 0, nVertices);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    current = 1 - current;
+    ++nSteps;
+}
+
+void FragmentShaderEngine::WaitForSteps()
+{
+    glFinish();
+}
+
+void FragmentShaderEngine::Draw(int viewportWidth, int viewportHeight)
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, viewportWidth, viewportHeight);
+
+    glUseProgram(drawProgram);
+    glUniform2i(glGetUniformLocation(drawProgram, "u_GridSize"), width, height);
+    glUniform2f(glGetUniformLocation(drawProgram, "u_ViewportSize"), static_cast<float>(viewportWidth), static_cast<float>(viewportHeight));
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, textures[current]);
+
+    glBindVertexArray(emptyVAO);
+    glDrawArrays(GL_TRIANGLES, 0, nVertices);
+}
+
+void FragmentShaderEngine::ReportStatistics(std::ostream& stream) const
+{
+    const size_t nTextureBytes = static_cast<size_t>(width) * static_cast<size_t>(height);
+
+    stream << "fragment: " << nSteps << " generations in full-screen passes, two " << nTextureBytes / 1024 << " KiB R8 textures\n";
+}
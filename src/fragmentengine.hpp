@@ -0,0 +1,48 @@
+#pragma once
+
+#include "cellgrid.hpp"
+#include "gpuengine.hpp"
+
+#include <array>
+#include <cstdint>
+
+// ------------------
+// Fragment Shader Engine
+// ------------------
+
+// Steps the game with a fragment shader, for drivers without compute shaders. The cells are two R8 textures of one
+// byte per cell, each attached to a framebuffer; every generation is one full-screen pass that reads one texture and
+// renders into the other. The texture wrap mode supplies the cells past the edges, so all edge modes cost the same.
+// Needs OpenGL 3.3.
+class FragmentShaderEngine : public GpuEngine {
+public:
+    FragmentShaderEngine(int width, int height, EdgeMode edgeMode);
+    ~FragmentShaderEngine() override;
+
+    FragmentShaderEngine(const FragmentShaderEngine&) = delete;
+    FragmentShaderEngine& operator=(const FragmentShaderEngine&) = delete;
+
+    std::string_view Name() const override { return "fragment"; }
+    void Load(const CellGrid& grid) override;
+    void Store(CellGrid& grid) const override;
+    void Step() override;
+    void WaitForSteps() override;
+    bool SupportsEdgeMode(EdgeMode) const override { return true; }
+    void ReportStatistics(std::ostream& stream) const override;
+    void Draw(int viewportWidth, int viewportHeight) override;
+
+private:
+    int width = 0;
+    int height = 0;
+
+    uint32_t stepProgram = 0;
+    uint32_t drawProgram = 0;
+    uint32_t emptyVAO = 0;
+
+    // textures[current] holds the current generation, and framebuffers[n] renders into textures[n].
+    std::array<uint32_t, 2> textures = { 0, 0 };
+    std::array<uint32_t, 2> framebuffers = { 0, 0 };
+    int current = 0;
+
+    uint64_t nSteps = 0;
+};
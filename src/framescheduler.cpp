@@ -0,0 +1,97 @@
+#include "framescheduler.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <utility>
+
+void Task::promise_type::unhandled_exception()
+{
+    std::cout << "Error: A frame task threw an exception\n";
+    std::terminate();
+}
+
+Task::Task(Task&& other) noexcept
+    : handle(std::exchange(other.handle, {}))
+{
+}
+
+Task& Task::operator=(Task&& other) noexcept
+{
+    if (this != &other) {
+        if (handle) {
+            handle.destroy();
+        }
+        handle = std::exchange(other.handle, {});
+    }
+
+    return *this;
+}
+
+Task::~Task()
+{
+    if (handle) {
+        handle.destroy();
+    }
+}
+
+FrameScheduler::FrameScheduler(Clock::duration m_budget)
+    : budget(m_budget)
+{
+}
+
+void FrameScheduler::Spawn(Task task)
+{
+    tasks.push_back(std::move(task));
+}
+
+bool FrameScheduler::HasBudgetLeft()
+{
+    const Clock::time_point now = Clock::now();
+    const Clock::duration lastPiece = now - lastCheckpoint;
+    lastCheckpoint = now;
+
+    return now + lastPiece <= deadline;
+}
+
+void FrameScheduler::RunFrame()
+{
+    if (tasks.empty()) {
+        return;
+    }
+
+    const Clock::time_point start = Clock::now();
+    deadline = start + budget;
+
+    const size_t nTasks = tasks.size();
+    for (size_t n = 0; n < nTasks; ++n) {
+        const size_t index = (firstTask + n) % nTasks;
+        lastCheckpoint = Clock::now();
+        if (lastCheckpoint >= deadline) {
+            break;
+        }
+
+        tasks[index].Resume();
+    }
+    firstTask = (firstTask + 1) % nTasks;
+
+    const Clock::duration overrun = Clock::now() - deadline;
+    ++nBusyFrames;
+    if (overrun > Clock::duration::zero()) {
+        ++nOverruns;
+        worstOverrun = std::max(worstOverrun, overrun);
+    }
+
+    tasks.erase(std::remove_if(tasks.begin(), tasks.end(), [](const Task& task) { return task.Done(); }), tasks.end());
+}
+
+void FrameScheduler::ReportStatistics(std::ostream& stream) const
+{
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    const double overrunRate = nBusyFrames == 0 ? 0.0 : 100.0 * static_cast<double>(nOverruns) / static_cast<double>(nBusyFrames);
+
+    stream << "frame tasks: " << nOverruns << " of " << nBusyFrames << " frames over the "
+           << Milliseconds(budget).count() << " ms budget (" << overrunRate << "%), worst by "
+           << Milliseconds(worstOverrun).count() << " ms\n";
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// ------------------
+// Frame Scheduler
+// ------------------
+
+// A coroutine run by a FrameScheduler. It starts suspended, and only runs when the scheduler resumes it.
+class Task {
+public:
+    struct promise_type {
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception();
+    };
+
+    Task(Task&& other) noexcept;
+    Task& operator=(Task&& other) noexcept;
+    ~Task();
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    bool Done() const { return handle.done(); }
+    void Resume() { handle.resume(); }
+
+private:
+    std::coroutine_handle<promise_type> handle;
+
+    explicit Task(std::coroutine_handle<promise_type> m_handle)
+        : handle(m_handle)
+    {
+    }
+};
+
+// Runs tasks that would otherwise block the main loop, like writing files or compiling shaders, on the main thread
+// between frames. Each frame the tasks get a time budget, and each task co_awaits Yield() between small pieces of work,
+// so polling events and swapping buffers are only delayed by about the budget.
+class FrameScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit FrameScheduler(Clock::duration budget);
+
+    FrameScheduler(const FrameScheduler&) = delete;
+    FrameScheduler& operator=(const FrameScheduler&) = delete;
+
+    void Spawn(Task task);
+
+    // Resume each task in turn until the frame's budget is spent, then drop the tasks that finished.
+    void RunFrame();
+
+    bool Idle() const { return tasks.empty(); }
+
+    // Continues straight away unless the next piece of work, guessed to take as long as the last one,
+    // would run past the frame's budget, in which case the task carries on in a later frame.
+    struct BudgetCheck {
+        FrameScheduler& scheduler;
+
+        bool await_ready() const { return scheduler.HasBudgetLeft(); }
+        void await_suspend(std::coroutine_handle<>) const {}
+        void await_resume() const {}
+    };
+
+    BudgetCheck Yield() { return { *this }; }
+
+    // Always carries on in the next frame, for work that can't be split and deserves a frame's budget of its own.
+    std::suspend_always NextFrame() const { return {}; }
+
+    // Frames in which tasks ran past the budget, out of the frames in which any task ran.
+    void ReportStatistics(std::ostream& stream) const;
+
+private:
+    Clock::duration budget;
+    Clock::time_point deadline;
+    Clock::time_point lastCheckpoint;
+
+    std::vector<Task> tasks;
+
+    // Frames start with a different task each time, so a task that always spends the budget can't starve the others.
+    size_t firstTask = 0;
+
+    uint64_t nBusyFrames = 0;
+    uint64_t nOverruns = 0;
+    Clock::duration worstOverrun = Clock::duration::zero();
+
+    bool HasBudgetLeft();
+};
@@ -0,0 +1,135 @@
+#include "generationstream.hpp"
+
+#include <algorithm>
+#include <array>
+#include <thread>
+
+namespace {
+    constexpr std::array<std::string_view, 3> backPressureNames = { "drop", "block", "coalesce" };
+
+    void CopySnapshot(const Snapshot& source, Snapshot& destination)
+    {
+        std::copy(source.grid.cells.begin(), source.grid.cells.end(), destination.grid.cells.begin());
+        destination.generation = source.generation;
+    }
+}
+
+std::string_view BackPressureName(BackPressure backPressure)
+{
+    return backPressureNames[static_cast<int>(backPressure)];
+}
+
+bool ParseBackPressure(std::string_view name, BackPressure& backPressure)
+{
+    for (size_t index = 0; index < backPressureNames.size(); ++index) {
+        if (name == backPressureNames[index]) {
+            backPressure = static_cast<BackPressure>(index);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+GenerationStream::GenerationStream(int width, int height, size_t capacity, BackPressure m_backPressure)
+    : backPressure(m_backPressure)
+    , staging { CellGrid(width, height), 0 }
+{
+    slots.reserve(capacity);
+    for (size_t slot = 0; slot < capacity; ++slot) {
+        slots.push_back({ CellGrid(width, height), 0 });
+    }
+}
+
+void GenerationStream::Push(const Snapshot& snapshot)
+{
+    const uint64_t headIndex = head.load(std::memory_order_relaxed);
+    CopySnapshot(snapshot, slots[headIndex % slots.size()]);
+
+    // Release, so the consumer sees the copied cells once it sees the new head.
+    head.store(headIndex + 1, std::memory_order_release);
+    nPublished.fetch_add(1, std::memory_order_relaxed);
+}
+
+void GenerationStream::Publish(const Snapshot& snapshot)
+{
+    if (Closed()) {
+        return;
+    }
+    newestGeneration.store(snapshot.generation, std::memory_order_relaxed);
+
+    // A generation set aside while the queue was full goes first, now that there may be room for it.
+    if (stagingPending && !Full(head.load(std::memory_order_relaxed))) {
+        Push(staging);
+        stagingPending = false;
+    }
+
+    // While one is still set aside the new generation can't overtake it, even if the consumer has just made room.
+    if (!stagingPending && !Full(head.load(std::memory_order_relaxed))) {
+        Push(snapshot);
+        return;
+    }
+
+    switch (backPressure) {
+    case BackPressure::DROP:
+        nDropped.fetch_add(1, std::memory_order_relaxed);
+        break;
+    case BackPressure::COALESCE:
+        // Whatever was set aside before is replaced by the newer generation.
+        if (stagingPending) {
+            nCoalesced.fetch_add(1, std::memory_order_relaxed);
+        }
+        CopySnapshot(snapshot, staging);
+        stagingPending = true;
+        break;
+    case BackPressure::BLOCK:
+        nBlocked.fetch_add(1, std::memory_order_relaxed);
+        while (Full(head.load(std::memory_order_relaxed))) {
+            if (Closed()) {
+                return;
+            }
+            std::this_thread::yield();
+        }
+        Push(snapshot);
+        break;
+    }
+}
+
+const Snapshot* GenerationStream::Front() const
+{
+    const uint64_t tailIndex = tail.load(std::memory_order_relaxed);
+    if (tailIndex == head.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+
+    return &slots[tailIndex % slots.size()];
+}
+
+void GenerationStream::Pop()
+{
+    // Release, so the producer doesn't overwrite the slot until the consumer is done reading it.
+    tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void GenerationStream::Close()
+{
+    closed.store(true, std::memory_order_relaxed);
+}
+
+uint64_t GenerationStream::Lag() const
+{
+    const Snapshot* front = Front();
+    const uint64_t newest = newestGeneration.load(std::memory_order_relaxed);
+
+    return front == nullptr ? 0 : newest - front->generation;
+}
+
+void GenerationStream::ReportStatistics(std::ostream& stream) const
+{
+    const uint64_t nQueued = head.load(std::memory_order_relaxed) - tail.load(std::memory_order_relaxed);
+
+    stream << "stream (" << BackPressureName(backPressure) << "): " << nPublished.load(std::memory_order_relaxed) << " published, "
+           << nDropped.load(std::memory_order_relaxed) << " dropped, " << nCoalesced.load(std::memory_order_relaxed) << " coalesced, "
+           << nBlocked.load(std::memory_order_relaxed) << " waits for the consumer, " << nQueued << " of " << slots.size()
+           << " slots queued, consumer " << Lag() << " generations behind\n";
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "cellgrid.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+// ------------------
+// Generation Stream
+// ------------------
+
+// A finished generation, as published by the simulation thread.
+struct Snapshot {
+    CellGrid grid;
+    uint64_t generation = 0;
+};
+
+// What a stream does with a new generation when its consumer hasn't made room for it.
+enum class BackPressure {
+    DROP = 0, // Discard the new generation. The simulation never waits, and the consumer sees gaps.
+    BLOCK = 1, // Wait for the consumer. It sees every generation, at the cost of holding up the simulation.
+    COALESCE = 2 // Keep only the newest generation aside, and queue it once there is room. The simulation never waits.
+};
+
+std::string_view BackPressureName(BackPressure backPressure);
+
+// Returns false if name isn't the name of a back-pressure policy.
+bool ParseBackPressure(std::string_view name, BackPressure& backPressure);
+
+// Bounded lock-free queue of read-only snapshots from the simulation thread to one consumer thread, such as a recorder
+// or a statistics collector. Every slot is allocated up front, so publishing is a copy of the grid and never allocates.
+// Each consumer gets its own stream, so consumers can't hold each other up.
+class GenerationStream {
+public:
+    GenerationStream(int width, int height, size_t capacity, BackPressure backPressure);
+
+    GenerationStream(const GenerationStream&) = delete;
+    GenerationStream& operator=(const GenerationStream&) = delete;
+
+    // Producer side: queue a copy of snapshot, or apply the back-pressure policy if the queue is full.
+    void Publish(const Snapshot& snapshot);
+
+    // Consumer side: the oldest queued snapshot, or nullptr if there is none. It stays valid until Pop().
+    const Snapshot* Front() const;
+    void Pop();
+
+    // Either side: stop blocking and accept no more snapshots, e.g. because the consumer or the producer is going away.
+    void Close();
+    bool Closed() const { return closed.load(std::memory_order_relaxed); }
+
+    // Generations between the newest one published and the oldest one the consumer hasn't popped yet.
+    uint64_t Lag() const;
+
+    void ReportStatistics(std::ostream& stream) const;
+
+private:
+    std::vector<Snapshot> slots;
+    BackPressure backPressure = BackPressure::DROP;
+
+    // Both only ever increase, and slot index % capacity is used for index. Each is written by one side only, and
+    // kept on its own cache line so the two sides don't slow each other down.
+    alignas(64) std::atomic<uint64_t> head { 0 };
+    alignas(64) std::atomic<uint64_t> tail { 0 };
+
+    alignas(64) std::atomic<bool> closed { false };
+
+    // Producer only: the newest generation that arrived while the queue was full, with COALESCE.
+    Snapshot staging;
+    bool stagingPending = false;
+
+    // Written by the producer only, read by anyone.
+    std::atomic<uint64_t> newestGeneration { 0 };
+    std::atomic<uint64_t> nPublished { 0 };
+    std::atomic<uint64_t> nDropped { 0 };
+    std::atomic<uint64_t> nCoalesced { 0 };
+    std::atomic<uint64_t> nBlocked { 0 };
+
+    bool Full(uint64_t headIndex) const { return headIndex - tail.load(std::memory_order_acquire) == slots.size(); }
+    void Push(const Snapshot& snapshot);
+};
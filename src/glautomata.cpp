@@ -16,15 +16,29 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include "allocationcounter.hpp"
+#include "cellgrid.hpp"
+#include "engine.hpp"
+#include "framescheduler.hpp"
+#include "gpuengine.hpp"
+#include "options.hpp"
+#include "patternfile.hpp"
+#include "populationmonitor.hpp"
+#include "shader.hpp"
+#include "simdkernel.hpp"
+#include "simulationthread.hpp"
+
+#include <algorithm>
 #include <array>
+#include <chrono>
 #include <cmath>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <ctime>
-#include <fstream>
 #include <iostream>
-#include <sstream>
+#include <limits>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -34,10 +48,14 @@
 // Globals
 // -------
 
-constexpr int windowSize = 1000; // window is always square.
-constexpr int gridSize = 250;
-constexpr float cellSize = static_cast<float>(windowSize) / static_cast<float>(gridSize);
 const std::string shaderPath = "../shader.glsl";
+const std::string cellTextureShaderPath = "../celltexture.glsl";
+const std::string instancedShaderPath = "../instanced.glsl";
+constexpr int nVerticesPerCell = 4;
+constexpr int nIndicesPerCell = 6;
+
+// Generations the population monitor's stream can hold before its back-pressure policy applies.
+constexpr size_t monitorStreamCapacity = 4;
 
 // ----------------------
 // Helper structs & enums
@@ -49,14 +67,11 @@ struct Vertex {
     glm::vec3 colour;
 };
 
-struct ShaderProgramSource {
-    std::string vertexSource;
-    std::string fragmentSource;
-};
-
-enum class State {
-    DEAD = 0,
-    ALIVE = 1
+// Size of the window and its cells, worked out from the grid dimensions at launch.
+struct WindowLayout {
+    int width = 0;
+    int height = 0;
+    float cellSize = 0.0f;
 };
 
 struct Cell {
@@ -73,9 +88,12 @@ struct Cell {
 // Program Management
 // ------------------
 
-void Initialize(GLFWwindow*& window);
+WindowLayout CreateWindowLayout(const Options& options);
+uint64_t EstimateRenderMemory(size_t nCells, Renderer renderer);
+void Initialize(GLFWwindow*& window, const WindowLayout& layout, bool visible);
 int Exit(GLFWwindow* window);
-void ProcessKeyboardInput(GLFWwindow* window, std::vector<Vertex>& buffer);
+void ProcessKeyboardInput(GLFWwindow* window, SimulationThread& simulation, FrameScheduler& scheduler, uint32_t& shader, const Options& options);
+bool KeyPressed(GLFWwindow* window, int key, bool& wasDown);
 void FramebufferSizeCallback(GLFWwindow* window, int width, int height); // Adjust size of viewport
 
 // ---------------------
@@ -84,60 +102,219 @@ void FramebufferSizeCallback(GLFWwindow* window, int width, int height); // Adju
 
 void APIENTRY GLDebugPrintMessage(GLenum source, GLenum type, unsigned int id, GLenum severity, int length, const char* message, const void* data);
 uint32_t CreateVAO();
-void CreateVBO();
-std::vector<uint32_t> CreateIBO();
+void CreateVBO(size_t nCells);
+std::vector<uint32_t> CreateIBO(size_t nCells);
 uint32_t CreateShader(const std::string_view shaderPath);
 void SpecifyLayout();
-void Render(GLFWwindow*& window, const uint32_t& VAO, const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, uint32_t shader);
+void Render(GLFWwindow*& window, const uint32_t& VAO, const CellGrid& grid, bool cellsChanged, std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, uint32_t shader);
+uint32_t CreateCellTexture(int width, int height);
+void RenderTexture(GLFWwindow* window, const CellGrid& grid, bool cellsChanged, uint32_t texture, uint32_t shader);
+uint32_t CreateInstanceBuffers(const CellGrid& grid);
+void RenderInstanced(GLFWwindow* window, const CellGrid& grid, bool cellsChanged, uint32_t stateBuffer, uint32_t shader, float cellSize);
 
 // ----------------
 // Shader Functions
 // ----------------
 
-ShaderProgramSource ParseShader(const std::string_view filepath);
-uint32_t CompileShader(uint32_t shaderType, const std::string_view shaderSource);
-uint32_t CreateShader(ShaderProgramSource& shaderSource);
+const std::string& RendererShaderPath(Renderer renderer);
+Task ReloadShader(FrameScheduler& scheduler, uint32_t& shader, const std::string& path);
 
 // ------------------
 // Game of Life Functions
 // ------------------
 
-std::vector<Vertex> CreateCell(Cell cell);
-State GetCellState(const std::vector<Vertex>& buffer, glm::vec2 position);
-void SetCellState(std::vector<Vertex>& buffer, Cell cell);
-void GenerateRandomCells(std::vector<Vertex>& buffer);
-void GameOfLife(std::vector<Vertex>& buffer);
-void RestartGame(std::vector<Vertex>& buffer);
-
-int main()
+std::array<Vertex, 4> CreateCell(Cell cell, float cellSize);
+std::vector<Vertex> CreateCellVertices(const CellGrid& grid, float cellSize);
+void UpdateCellVertices(const CellGrid& grid, std::vector<Vertex>& vertices);
+void GenerateRandomCells(CellGrid& grid);
+void RestartGame(SimulationThread& simulation);
+void RunBenchmark(Engine& engine, CellGrid& grid, int nSteps);
+void RunGpuGame(GLFWwindow* window, GpuEngine& engine, CellGrid& grid, const Options& options);
+int RunAllocationCheck(const Options& options);
+uint64_t CountRenderAllocations(const Options& options, const CellGrid& grid);
+
+int main(int argc, char** argv)
 {
+    const Options options = ParseArguments(argc, argv);
+
+    if (options.instructionSet && !SelectInstructionSet(*options.instructionSet)) {
+        std::cout << "Error: This CPU doesn't support " << InstructionSetName(*options.instructionSet) << ", the best it supports is "
+                  << InstructionSetName(SupportedInstructionSet()) << "\n";
+        return EXIT_FAILURE;
+    }
+
+    if (options.allocationCheckSteps > 0) {
+        return RunAllocationCheck(options);
+    }
+
+    // Check everything fits before allocating any of it.
+    constexpr uint64_t bytesPerMiB = 1024 * 1024;
+    const size_t nCells = static_cast<size_t>(options.width) * static_cast<size_t>(options.height);
+    // One grid to load the engine from, and when rendering three more in the triple buffer, one for restarts,
+    // and the monitor's stream slots plus one it sets aside.
+    // GPU engines step on the render thread and draw their own cells, so they need neither.
+    const bool needsOpenGL = EngineNeedsOpenGL(options);
+    const uint64_t nStreamGrids = options.monitorInterval > 0 ? monitorStreamCapacity + 1 : 0;
+    const uint64_t nViewGrids = options.benchmarkSteps > 0 || needsOpenGL ? 1 : 5 + nStreamGrids;
+    const uint64_t viewMemory = nViewGrids * static_cast<uint64_t>(options.width + 2) * static_cast<uint64_t>(options.height + 2);
+    const uint64_t engineMemory = EstimateEngineMemory(options, options.width, options.height);
+    const uint64_t renderMemory = options.benchmarkSteps > 0 || needsOpenGL ? 0 : EstimateRenderMemory(nCells, options.renderer);
+    const uint64_t requiredMemory = viewMemory + engineMemory + renderMemory;
+
+    if (requiredMemory > options.memoryBudgetMiB * bytesPerMiB) {
+        std::cout << "Error: A " << options.width << "x" << options.height << " grid needs about " << requiredMemory / bytesPerMiB
+                  << " MiB (" << engineMemory / bytesPerMiB << " MiB for the engine, " << renderMemory / bytesPerMiB
+                  << " MiB for rendering), over the memory budget of " << options.memoryBudgetMiB << " MiB.\n"
+                  << "Use a smaller grid, or raise the budget with --memory-budget.\n";
+        return EXIT_FAILURE;
+    }
+
+    const WindowLayout layout = CreateWindowLayout(options);
     GLFWwindow* window = nullptr;
-    Initialize(window);
 
-    constexpr int nVerticesPerCell = 4;
-    constexpr int nVertices = (gridSize * gridSize) * nVerticesPerCell;
+    // GPU engines create their buffers in the OpenGL context, so it has to exist first. Benchmarks keep it hidden.
+    if (needsOpenGL) {
+        Initialize(window, layout, options.benchmarkSteps == 0);
+    }
 
-    const uint32_t VAO = CreateVAO();
-    CreateVBO();
-    const std::vector<uint32_t> cellIndices = CreateIBO();
-    SpecifyLayout();
-    const uint32_t shader = CreateShader(shaderPath);
+    std::unique_ptr<Engine> engine = CreateEngine(options, options.width, options.height);
+    if (engine == nullptr) {
+        std::cout << "Error: Unknown engine \"" << options.engine << "\". Available engines: " << EngineNames() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    if (!engine->SupportsEdgeMode(options.edgeMode)) {
+        std::cout << "Error: The " << engine->Name() << " engine doesn't support " << EdgeModeName(options.edgeMode)
+                  << " edges. Use bytegrid, tiled, processes, compute, packed or fragment, or --edges dead.\n";
+        return EXIT_FAILURE;
+    }
+
+    if (engine->Name() == "bytegrid") {
+        std::cout << "Neighbour-sum kernel: " << InstructionSetName(SelectedInstructionSet()) << "\n";
+    }
+
+    // The engine's own grids were placed by its threads, so filling this one serially doesn't matter; Load() copies it over.
+    CellGrid grid(options.width, options.height);
+    GenerateRandomCells(grid);
+    engine->Load(grid);
+
+    if (options.reportNodes) {
+        engine->ReportMemoryPlacement(std::cout);
+    }
+
+    if (options.benchmarkSteps > 0) {
+        RunBenchmark(*engine, grid, options.benchmarkSteps);
+
+        if (options.printStatistics) {
+            engine->ReportStatistics(std::cout);
+        }
+        if (window != nullptr) {
+            // The engine's buffers belong to the context, so they are deleted before it is.
+            engine.reset();
+            Exit(window);
+        }
+        return EXIT_SUCCESS;
+    }
+
+    if (auto* gpuEngine = dynamic_cast<GpuEngine*>(engine.get())) {
+        RunGpuGame(window, *gpuEngine, grid, options);
+        engine.reset();
+        Exit(window);
+    }
+
+    // Vertices are indexed with 32 bits, and drawn with a signed 32 bit count.
+    if (options.renderer == Renderer::QUADS && nCells * nIndicesPerCell > static_cast<size_t>(std::numeric_limits<int32_t>::max())) {
+        std::cout << "Error: A " << options.width << "x" << options.height << " grid has too many cells to draw as quads, use --renderer texture or --benchmark instead.\n";
+        return EXIT_FAILURE;
+    }
+
+    // Instances are drawn with a signed 32 bit count, one per cell of each row and its halo.
+    const size_t nInstanceRows = static_cast<size_t>(options.height);
+    if (options.renderer == Renderer::INSTANCED && nInstanceRows * (options.width + 2) > static_cast<size_t>(std::numeric_limits<int32_t>::max())) {
+        std::cout << "Error: A " << options.width << "x" << options.height << " grid has too many cells to draw as instances, use --renderer texture or --benchmark instead.\n";
+        return EXIT_FAILURE;
+    }
 
+    Initialize(window, layout, true);
+
+    // The texture renderer's vertex array has no attributes; its triangle is positioned by the vertex shader.
+    // The instanced renderer's has a unit quad, and a byte of state per instance.
+    const uint32_t VAO = CreateVAO();
+    std::vector<uint32_t> cellIndices;
     std::vector<Vertex> cellVertices;
-    cellVertices.reserve(nVertices);
+    uint32_t cellTexture = 0;
+    uint32_t stateBuffer = 0;
+    if (options.renderer == Renderer::QUADS) {
+        CreateVBO(nCells);
+        cellIndices = CreateIBO(nCells);
+        SpecifyLayout();
+
+        // Allocated once; the cell colours are derived from the grid every time a frame is drawn.
+        cellVertices = CreateCellVertices(grid, layout.cellSize);
+    } else if (options.renderer == Renderer::TEXTURE) {
+        cellTexture = CreateCellTexture(options.width, options.height);
+    } else {
+        stateBuffer = CreateInstanceBuffers(grid);
+    }
+    uint32_t shader = CreateShader(RendererShaderPath(options.renderer));
+
+    // The monitor consumes every generation it can keep up with from a stream of its own, on its own thread.
+    std::unique_ptr<GenerationStream> monitorStream;
+    std::unique_ptr<PopulationMonitor> monitor;
+    std::vector<GenerationStream*> streams;
+    if (options.monitorInterval > 0) {
+        monitorStream = std::make_unique<GenerationStream>(options.width, options.height, monitorStreamCapacity, options.streamBackPressure);
+        monitor = std::make_unique<PopulationMonitor>(*monitorStream, options.monitorInterval);
+        streams.push_back(monitorStream.get());
+    }
+
+    // The game runs on its own thread from here on, and each frame draws the newest generation it has finished.
+    SimulationThread simulation(*engine, grid, options.generationsPerSecond, options.printStatistics ? options.statisticsInterval : 0, streams);
 
-    GenerateRandomCells(cellVertices);
+    // Saving, loading and shader reloads run between frames, a slice of the budget at a time.
+    FrameScheduler scheduler(std::chrono::microseconds(options.frameBudgetMicroseconds));
 
+    // Engines whose steps allocate do so on the simulation thread, which the global allocation count can't tell apart.
+    const bool checkAllocations = !engine->AllocatesInStep();
+
+    bool firstFrame = true;
+    bool tasksRanLastFrame = false;
     while (!glfwWindowShouldClose(window)) {
-        Render(window, VAO, cellVertices, cellIndices, shader);
+        const uint64_t allocationCount = AllocationCount();
 
-        // Update Game of Life every frame.
-        GameOfLife(cellVertices);
+        const bool newGeneration = simulation.Update() || firstFrame;
+        if (options.renderer == Renderer::QUADS) {
+            Render(window, VAO, simulation.LatestSnapshot().grid, newGeneration, cellVertices, cellIndices, shader);
+        } else if (options.renderer == Renderer::TEXTURE) {
+            RenderTexture(window, simulation.LatestSnapshot().grid, newGeneration, cellTexture, shader);
+        } else {
+            RenderInstanced(window, simulation.LatestSnapshot().grid, newGeneration, stateBuffer, shader, layout.cellSize);
+        }
 
-        // Restart game if space key is pressed
-        ProcessKeyboardInput(window, cellVertices);
+        // Restart game if space key is pressed, and start tasks for the other keys.
+        ProcessKeyboardInput(window, simulation, scheduler, shader, options);
+
+        // Read before the tasks run, so that one spawned this frame counts even if it finishes within it.
+        const bool tasksIdle = scheduler.Idle();
+        scheduler.RunFrame();
+
+        // Everything is allocated up front, so after the first frame the loop must not touch the heap,
+        // except for the tasks, which read and write files, and the key presses that start them. Nor is the frame
+        // after a task checked, as drivers may only compile a reloaded shader once it is first drawn with.
+        if (!firstFrame && checkAllocations && tasksIdle && !tasksRanLastFrame) {
+            AssertNoAllocationsSince(allocationCount, "the render and simulation loops");
+        }
+        firstFrame = false;
+        tasksRanLastFrame = !tasksIdle;
     }
 
+    simulation.Stop();
+    if (monitor != nullptr) {
+        monitor->Stop();
+    }
+    if (options.printStatistics) {
+        scheduler.ReportStatistics(std::cout);
+    }
     Exit(window);
 }
 
@@ -145,7 +322,32 @@ int main()
 // Program Management
 // ------------------
 
-void Initialize(GLFWwindow*& window)
+WindowLayout CreateWindowLayout(const Options& options)
+{
+    // The longest side of the grid fills windowSize pixels, and cells stay square.
+    WindowLayout layout;
+    layout.cellSize = static_cast<float>(options.windowSize) / static_cast<float>(std::max(options.width, options.height));
+    layout.width = std::max(1, static_cast<int>(std::lround(options.width * layout.cellSize)));
+    layout.height = std::max(1, static_cast<int>(std::lround(options.height * layout.cellSize)));
+
+    return layout;
+}
+
+uint64_t EstimateRenderMemory(size_t nCells, Renderer renderer)
+{
+    // A texture, or a buffer of instance states, holds a byte per cell, which is uploaded straight from the newest generation.
+    if (renderer == Renderer::TEXTURE || renderer == Renderer::INSTANCED) {
+        return static_cast<uint64_t>(nCells);
+    }
+
+    // The vertices and indices are held on the CPU, and again in the GPU's buffers.
+    const uint64_t vertexBytes = static_cast<uint64_t>(nCells) * nVerticesPerCell * sizeof(Vertex);
+    const uint64_t indexBytes = static_cast<uint64_t>(nCells) * nIndicesPerCell * sizeof(uint32_t);
+
+    return 2 * (vertexBytes + indexBytes);
+}
+
+void Initialize(GLFWwindow*& window, const WindowLayout& layout, bool visible)
 {
     // GLFW Setup
     if (!glfwInit()) {
@@ -155,9 +357,7 @@ void Initialize(GLFWwindow*& window)
         exit(EXIT_FAILURE);
     }
 
-    // Use OpenGL 4.6 Core
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+    // Use OpenGL Core
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
     glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
 
@@ -166,9 +366,20 @@ void Initialize(GLFWwindow*& window)
 
     // GLFW Options
     glfwWindowHint(GLFW_RESIZABLE, GL_FALSE);
-
-    // Create window
-    window = glfwCreateWindow(windowSize, windowSize, "Glautomata - John Conway's Game of Life", nullptr, nullptr);
+    glfwWindowHint(GLFW_VISIBLE, visible ? GLFW_TRUE : GLFW_FALSE);
+
+    // Create window, with the newest version of OpenGL the driver has. Drivers without 4.6, like Mesa's llvmpipe,
+    // fail to create the context rather than giving an older one. The compute and packed engines need 4.3, the rest 3.3.
+    constexpr std::array<std::pair<int, int>, 4> contextVersions = { { { 4, 6 }, { 4, 5 }, { 4, 3 }, { 3, 3 } } };
+    for (const auto& [major, minor] : contextVersions) {
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, major);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, minor);
+
+        window = glfwCreateWindow(layout.width, layout.height, "Glautomata - John Conway's Game of Life", nullptr, nullptr);
+        if (window != nullptr) {
+            break;
+        }
+    }
 
     if (window == nullptr) {
         std::cout << "GLFW window creation failed\n"
@@ -185,11 +396,12 @@ void Initialize(GLFWwindow*& window)
     if (error != GLEW_OK) {
         std::cout << "Error: Failed to initialize OpenGL function pointer loader!\n";
     }
+    std::cout << "OpenGL " << glGetString(GL_VERSION) << "\n";
 
     // Enable debugging layer of OpenGL
     int glFlags = 0;
     glGetIntegerv(GL_CONTEXT_FLAGS, &glFlags);
-    if (glFlags & GL_CONTEXT_FLAG_DEBUG_BIT) {
+    if ((glFlags & GL_CONTEXT_FLAG_DEBUG_BIT) && (GLEW_KHR_debug || GLEW_VERSION_4_3)) {
         glEnable(GL_DEBUG_OUTPUT);
         glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
 
@@ -209,11 +421,46 @@ int Exit(GLFWwindow* window)
     std::exit(EXIT_SUCCESS);
 }
 
-void ProcessKeyboardInput(GLFWwindow* window, std::vector<Vertex>& buffer)
+void ProcessKeyboardInput(GLFWwindow* window, SimulationThread& simulation, FrameScheduler& scheduler, uint32_t& shader, const Options& options)
 {
     if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS) {
-        RestartGame(buffer);
+        RestartGame(simulation);
+    }
+
+    // The other keys start a task once per press, rather than once per frame while held.
+    static bool saveKeyDown = false;
+    static bool loadKeyDown = false;
+    static bool reloadKeyDown = false;
+
+    // S writes the generation on screen to a file.
+    if (KeyPressed(window, GLFW_KEY_S, saveKeyDown)) {
+        const Snapshot& snapshot = simulation.LatestSnapshot();
+        const std::string path = "generation-" + std::to_string(snapshot.generation) + ".cells";
+        scheduler.Spawn(WritePatternFile(scheduler, snapshot.grid, snapshot.generation, path));
     }
+
+    // L restarts the game from the --pattern file.
+    if (KeyPressed(window, GLFW_KEY_L, loadKeyDown)) {
+        if (options.patternPath.empty()) {
+            std::cout << "No pattern to load, pass one with --pattern\n";
+        } else {
+            scheduler.Spawn(LoadPatternFile(scheduler, simulation, options.patternPath));
+        }
+    }
+
+    // R recompiles the renderer's shader from its file.
+    if (KeyPressed(window, GLFW_KEY_R, reloadKeyDown)) {
+        scheduler.Spawn(ReloadShader(scheduler, shader, RendererShaderPath(options.renderer)));
+    }
+}
+
+bool KeyPressed(GLFWwindow* window, int key, bool& wasDown)
+{
+    const bool down = glfwGetKey(window, key) == GLFW_PRESS;
+    const bool pressed = down && !wasDown;
+    wasDown = down;
+
+    return pressed;
 }
 
 void FramebufferSizeCallback(GLFWwindow* window, int width, int height)
@@ -347,12 +594,10 @@ uint32_t CreateVAO()
     return VAO;
 }
 
-void CreateVBO()
+void CreateVBO(size_t nCells)
 {
-    constexpr int nVerticesPerCell = 4;
-    constexpr int nVertices = (gridSize * gridSize) * nVerticesPerCell;
     constexpr int nBuffers = 1;
-    const int nVertexBytes = nVertices * sizeof(Vertex);
+    const GLsizeiptr nVertexBytes = static_cast<GLsizeiptr>(nCells * nVerticesPerCell * sizeof(Vertex));
 
     // Create Vertex Buffer Object
     uint32_t VBO = 0;
@@ -361,27 +606,28 @@ void CreateVBO()
     glBufferData(GL_ARRAY_BUFFER, nVertexBytes, nullptr, GL_DYNAMIC_DRAW); // passed in nullptr as data will be copied later.
 }
 
-std::vector<uint32_t> CreateIBO()
+std::vector<uint32_t> CreateIBO(size_t nCells)
 {
     constexpr int nBuffers = 1;
-    constexpr int nVerticesPerCell = 4;
 
     std::vector<uint32_t> indices;
-    for (int index = 0; index < std::pow(gridSize, 2); ++index) {
+    indices.reserve(nCells * nIndicesPerCell);
+    for (size_t index = 0; index < nCells; ++index) {
         // The final digit in the expression is the pattern of the indices for each cell
-        indices.push_back((index * nVerticesPerCell) + 0);
-        indices.push_back((index * nVerticesPerCell) + 1);
-        indices.push_back((index * nVerticesPerCell) + 2);
-        indices.push_back((index * nVerticesPerCell) + 0);
-        indices.push_back((index * nVerticesPerCell) + 2);
-        indices.push_back((index * nVerticesPerCell) + 3);
+        const uint32_t firstVertex = static_cast<uint32_t>(index * nVerticesPerCell);
+        indices.push_back(firstVertex + 0);
+        indices.push_back(firstVertex + 1);
+        indices.push_back(firstVertex + 2);
+        indices.push_back(firstVertex + 0);
+        indices.push_back(firstVertex + 2);
+        indices.push_back(firstVertex + 3);
     }
 
     // Create Index Buffer Object
     uint32_t IBO = 0;
     glGenBuffers(nBuffers, &IBO);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_DYNAMIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(indices.size() * sizeof(uint32_t)), indices.data(), GL_DYNAMIC_DRAW);
 
     return indices;
 }
@@ -414,11 +660,16 @@ void SpecifyLayout()
     glEnableVertexAttribArray(colourAttribute);
 }
 
-void Render(GLFWwindow*& window, const uint32_t& VAO, const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, uint32_t shader)
+void Render(GLFWwindow*& window, const uint32_t& VAO, const CellGrid& grid, bool cellsChanged, std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, uint32_t shader)
 {
-    // Set dynamic buffer
-    glBindBuffer(GL_ARRAY_BUFFER, VAO);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(Vertex), vertices.data());
+    // Derive the vertices from the simulation state only now that they are needed, and only if it has moved on since the last frame.
+    if (cellsChanged) {
+        UpdateCellVertices(grid, vertices);
+
+        // Set dynamic buffer
+        glBindBuffer(GL_ARRAY_BUFFER, VAO);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(vertices.size() * sizeof(Vertex)), vertices.data());
+    }
 
     // Clear screen
     glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
@@ -435,113 +686,181 @@ void Render(GLFWwindow*& window, const uint32_t& VAO, const std::vector<Vertex>&
     constexpr int nElements = 1;
     glUniformMatrix4fv(glGetUniformLocation(shader, "u_MVP"), nElements, GL_FALSE, &projection[0][0]);
 
-    glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, nullptr);
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, nullptr);
 
     // Update screen
     glfwSwapBuffers(window);
     glfwPollEvents();
 }
 
-// ----------------
-// Shader Functions
-// ----------------
-
-ShaderProgramSource ParseShader(const std::string_view filepath)
+uint32_t CreateCellTexture(int width, int height)
 {
-    // For separating the two stringstreams.
-    enum class ShaderType {
-        NONE = -1,
-        VERTEX = 0,
-        FRAGMENT = 1
-    };
+    GLint maxTextureSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+    if (width > maxTextureSize || height > maxTextureSize) {
+        std::cout << "Error: A " << width << "x" << height << " grid doesn't fit in a texture, which this driver limits to "
+                  << maxTextureSize << " texels a side. Use --renderer quads or a smaller grid.\n";
+        exit(EXIT_FAILURE);
+    }
 
-    std::ifstream stream(filepath.data());
-    std::array<std::stringstream, 2> ss;
+    constexpr int nTextures = 1;
 
-    std::string line = "";
-    ShaderType type = ShaderType::NONE;
+    // One texel per cell, which is non-zero for alive cells. Grids larger than the window are sampled a texel per pixel.
+    uint32_t texture = 0;
+    glGenTextures(nTextures, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 
-    // Read lines from the file while separating the two shader types into different stringstreams.
-    while (getline(stream, line)) {
-        if (line.find("#shader") != std::string::npos) {
-            if (line.find("vertex") != std::string::npos) {
-                type = ShaderType::VERTEX;
-            } else if (line.find("fragment") != std::string::npos) {
-                type = ShaderType::FRAGMENT;
-            }
-        } else {
-            ss[static_cast<int>(type)] << line << "\n";
-        }
+    return texture;
+}
+
+void RenderTexture(GLFWwindow* window, const CellGrid& grid, bool cellsChanged, uint32_t texture, uint32_t shader)
+{
+    glBindTexture(GL_TEXTURE_2D, texture);
+
+    // Only a byte per cell is uploaded, straight from the grid's rows. The row length skips the halo between them.
+    if (cellsChanged) {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, grid.stride);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, grid.width, grid.height, GL_RED, GL_UNSIGNED_BYTE, Row(grid, 0));
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
     }
 
-    ShaderProgramSource shaders;
-    shaders.vertexSource = ss[0].str();
-    shaders.fragmentSource = ss[1].str();
+    int framebufferWidth = 0;
+    int framebufferHeight = 0;
+    glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+    glViewport(0, 0, framebufferWidth, framebufferHeight);
 
-    return shaders;
+    glUniform2i(glGetUniformLocation(shader, "u_GridSize"), grid.width, grid.height);
+    glUniform2f(glGetUniformLocation(shader, "u_ViewportSize"), static_cast<float>(framebufferWidth), static_cast<float>(framebufferHeight));
+
+    // A single triangle covers the viewport, and the fragment shader looks up the cell under each pixel.
+    constexpr int nVertices = 3;
+    glDrawArrays(GL_TRIANGLES, 0, nVertices);
+
+    // Update screen
+    glfwSwapBuffers(window);
+    glfwPollEvents();
 }
 
-uint32_t CompileShader(uint32_t shaderType, const std::string_view shaderSource)
+uint32_t CreateInstanceBuffers(const CellGrid& grid)
 {
-    uint32_t id = glCreateShader(shaderType);
+    constexpr int nBuffers = 1;
+    constexpr int cornerAttribute = 0;
+    constexpr int stateAttribute = 1;
+    constexpr int nFloatsInCorner = 2;
+    constexpr int nStatesInAttribute = 1;
+
+    // Every instance draws the same unit quad, as a strip of two triangles, scaled and moved into place by the vertex shader.
+    constexpr std::array<glm::vec2, 4> unitQuad = { { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 0.0f, 1.0f }, { 1.0f, 1.0f } } };
+    uint32_t quadBuffer = 0;
+    glGenBuffers(nBuffers, &quadBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, quadBuffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(unitQuad), unitQuad.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(cornerAttribute, nFloatsInCorner, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), nullptr);
+    glEnableVertexAttribArray(cornerAttribute);
+
+    // One byte per instance, advanced once per instance rather than per vertex. The buffer holds the grid's rows from
+    // the first cell to the last with the halo in between, so it is filled with a single copy.
+    const GLsizeiptr nStateBytes = static_cast<GLsizeiptr>((static_cast<size_t>(grid.height - 1) * grid.stride) + grid.width);
+    uint32_t stateBuffer = 0;
+    glGenBuffers(nBuffers, &stateBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, stateBuffer);
+    glBufferData(GL_ARRAY_BUFFER, nStateBytes, nullptr, GL_DYNAMIC_DRAW);
+    glVertexAttribIPointer(stateAttribute, nStatesInAttribute, GL_UNSIGNED_BYTE, sizeof(uint8_t), nullptr);
+    glVertexAttribDivisor(stateAttribute, 1);
+    glEnableVertexAttribArray(stateAttribute);
+
+    return stateBuffer;
+}
 
-    const char* src = shaderSource.data();
+void RenderInstanced(GLFWwindow* window, const CellGrid& grid, bool cellsChanged, uint32_t stateBuffer, uint32_t shader, float cellSize)
+{
+    const GLsizei nInstances = static_cast<GLsizei>((static_cast<size_t>(grid.height - 1) * grid.stride) + grid.width);
 
-    constexpr int nShaderSources = 1;
-    glShaderSource(id, nShaderSources, &src, nullptr);
-    glCompileShader(id);
+    // Only the cell states are uploaded, a byte each, straight from the grid.
+    if (cellsChanged) {
+        glBindBuffer(GL_ARRAY_BUFFER, stateBuffer);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, nInstances, Row(grid, 0));
+    }
 
-    // Error handling.
-    int result = 0;
-    glGetShaderiv(id, GL_COMPILE_STATUS, &result);
-    if (result == GL_FALSE) {
-        int errorMessageLength = 0;
-        glGetShaderiv(id, GL_INFO_LOG_LENGTH, &errorMessageLength);
-        std::string message = "";
-        glGetShaderInfoLog(id, errorMessageLength, &errorMessageLength, message.data());
+    // Clear screen
+    glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
 
-        // Simple logging
-        std::cout << "Failed to compile " << (shaderType == GL_VERTEX_SHADER ? "vertex" : "fragment") << " shader!\n"
-                  << message << std::endl;
+    int currentWindowWidth = 0;
+    int currentWindowHeight = 0;
+    glfwGetWindowSize(window, &currentWindowWidth, &currentWindowHeight);
+    glfwSetFramebufferSizeCallback(window, FramebufferSizeCallback);
 
-        glDeleteShader(id);
+    // Orthographic project matrix, as for the quads.
+    const glm::mat4 projection = glm::ortho(0.0f, (float)currentWindowWidth, 0.0f, (float)currentWindowHeight, 0.0f, 100.0f);
+    constexpr int nElements = 1;
+    glUniformMatrix4fv(glGetUniformLocation(shader, "u_MVP"), nElements, GL_FALSE, &projection[0][0]);
+    glUniform1f(glGetUniformLocation(shader, "u_CellSize"), cellSize);
+    glUniform1i(glGetUniformLocation(shader, "u_Stride"), grid.stride);
+    glUniform1i(glGetUniformLocation(shader, "u_GridWidth"), grid.width);
 
-        // id set to 0 as shader was not compiled
-        id = 0;
-    }
+    constexpr int nQuadVertices = 4;
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, nQuadVertices, nInstances);
 
-    return id;
+    // Update screen
+    glfwSwapBuffers(window);
+    glfwPollEvents();
 }
 
-uint32_t CreateShader(ShaderProgramSource& source)
-{
-    const uint32_t program = glCreateProgram();
-    const uint32_t vs = CompileShader(GL_VERTEX_SHADER, source.vertexSource);
-    const uint32_t fs = CompileShader(GL_FRAGMENT_SHADER, source.fragmentSource);
+// ----------------
+// Shader Functions
+// ----------------
 
-    // These steps create an executable that is run on the programmable vertex/fragment shader processer on the GPU.
-    glAttachShader(program, vs);
-    glAttachShader(program, fs);
-    glLinkProgram(program);
-    glValidateProgram(program);
+const std::string& RendererShaderPath(Renderer renderer)
+{
+    switch (renderer) {
+    case Renderer::TEXTURE:
+        return cellTextureShaderPath;
+    case Renderer::INSTANCED:
+        return instancedShaderPath;
+    default:
+        return shaderPath;
+    }
+}
 
-    // Delete to shaders once they have been linked and compiled.
-    glDeleteShader(vs);
-    glDeleteShader(fs);
+Task ReloadShader(FrameScheduler& scheduler, uint32_t& shader, const std::string& path)
+{
+    // Reading, compiling and checking the result each get a frame of their own. Drivers that compile
+    // in the background can get on with it in between, so the status query at the end needn't wait.
+    ShaderProgramSource source = ParseShader(path);
+    co_await scheduler.NextFrame();
+
+    const uint32_t program = CreateShader(source);
+    co_await scheduler.NextFrame();
+
+    int linked = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (linked == GL_FALSE) {
+        std::cout << "Failed to link the reloaded shader, keeping the old one\n";
+        glDeleteProgram(program);
+        co_return;
+    }
 
-    return program;
+    glDeleteProgram(shader);
+    shader = program;
+    glUseProgram(shader);
+    std::cout << "Reloaded " << path << "\n";
 }
 
 // ------------------
 // Game of Life Functions
 // ------------------
 
-std::vector<Vertex> CreateCell(Cell cell)
+std::array<Vertex, 4> CreateCell(Cell cell, float cellSize)
 {
     constexpr glm::vec3 colourBlack = { 0.0f, 0.0f, 0.0f };
     constexpr glm::vec3 colourWhite = { 1.0f, 1.0f, 1.0f };
 
-    std::vector<Vertex> cellVertices(4);
+    std::array<Vertex, 4> cellVertices;
     const glm::vec3 cellColour = static_cast<bool>(cell.state) ? colourWhite : colourBlack;
 
     // Adjust each position for the size of a cell
@@ -560,114 +879,271 @@ std::vector<Vertex> CreateCell(Cell cell)
     return cellVertices;
 }
 
-State GetCellState(const std::vector<Vertex>& buffer, glm::vec2 position)
+std::vector<Vertex> CreateCellVertices(const CellGrid& grid, float cellSize)
 {
-    constexpr glm::vec3 colourWhite = { 1.0f, 1.0f, 1.0f };
-    constexpr int nVertices = 4;
-
-    State state = State::DEAD;
-
-    if (position.x >= 0 && position.y >= 0) {
-        // Convert 2D position to 1D array
-        const uint32_t index = ((position.x * gridSize) + position.y) * nVertices;
+    std::vector<Vertex> vertices;
+    vertices.reserve(static_cast<size_t>(grid.width) * grid.height * nVerticesPerCell);
 
-        if (index < buffer.size()) {
-            if (buffer.at(index).colour == colourWhite) {
-                state = State::ALIVE;
-            }
+    for (int y = 0; y < grid.height; ++y) {
+        for (int x = 0; x < grid.width; ++x) {
+            const auto cell = CreateCell({ { static_cast<float>(x), static_cast<float>(y) }, GetCellState(grid, x, y) }, cellSize);
+            vertices.insert(vertices.end(), cell.begin(), cell.end());
         }
     }
-    return state;
+
+    return vertices;
 }
 
-void SetCellState(std::vector<Vertex>& buffer, Cell cell)
+void UpdateCellVertices(const CellGrid& grid, std::vector<Vertex>& vertices)
 {
     constexpr glm::vec3 colourBlack = { 0.0f, 0.0f, 0.0f };
     constexpr glm::vec3 colourWhite = { 1.0f, 1.0f, 1.0f };
-    constexpr int nVertices = 4;
 
-    const uint32_t index = ((cell.position.x * gridSize) + cell.position.y) * nVertices;
+    // Cell positions never change, so only the colours are rewritten in place.
+    // Vertices are in the same row-major order as the grid's cells.
+    Vertex* cellVertices = vertices.data();
+    for (int y = 0; y < grid.height; ++y) {
+        const uint8_t* row = Row(grid, y);
+
+        for (int x = 0; x < grid.width; ++x) {
+            const glm::vec3 cellColour = row[x] ? colourWhite : colourBlack;
 
-    if (index < buffer.size()) {
-        for (int x = 0; x < 4; ++x) {
-            buffer.at(index + x).colour = static_cast<bool>(cell.state) ? colourWhite : colourBlack;
+            for (int vertex = 0; vertex < nVerticesPerCell; ++vertex) {
+                cellVertices[vertex].colour = cellColour;
+            }
+            cellVertices += nVerticesPerCell;
         }
     }
 }
 
-void GenerateRandomCells(std::vector<Vertex>& buffer)
+void GenerateRandomCells(CellGrid& grid)
 {
     // Seed srand() with the current time.
     std::srand(std::time(nullptr));
 
-    for (int x = 0; x < gridSize; ++x) {
-        for (int y = 0; y < gridSize; ++y) {
-            auto cell = CreateCell({ { x, y }, rand() % 2 ? State::ALIVE : State::DEAD });
-            buffer.insert(buffer.end(), cell.begin(), cell.end());
+    for (int y = 0; y < grid.height; ++y) {
+        for (int x = 0; x < grid.width; ++x) {
+            SetCellState(grid, x, y, rand() % 2 ? State::ALIVE : State::DEAD);
         }
     }
 }
 
-void GameOfLife(std::vector<Vertex>& buffer)
+void RestartGame(SimulationThread& simulation)
 {
-    // Write to tempBuffer while reading "cells" in buffer
-    std::vector<Vertex> tempBuffer;
-    tempBuffer.reserve(std::pow(gridSize, 2) * 4);
+    simulation.RequestRestart(GenerateRandomCells);
+}
 
-    // Iterate over grid of cells.
-    for (int cellPosX = 0; cellPosX < gridSize; ++cellPosX) {
-        for (int cellPosY = 0; cellPosY < gridSize; ++cellPosY) {
+void RunBenchmark(Engine& engine, CellGrid& grid, int nSteps)
+{
+    using Clock = std::chrono::steady_clock;
 
-            int nAliveNeighbours = 0;
-            for (int neighbourIndex_X = -1; neighbourIndex_X <= 1; ++neighbourIndex_X) {
-                for (int neighbourIndex_Y = -1; neighbourIndex_Y <= 1; ++neighbourIndex_Y) {
+    const uint64_t allocationCount = AllocationCount();
 
-                    // Don't check {0, 0} as that's the current cell.
-                    if (neighbourIndex_X != 0 || neighbourIndex_Y != 0) {
+    const auto start = Clock::now();
+    for (int step = 0; step < nSteps; ++step) {
+        engine.Step();
+    }
+    engine.WaitForSteps();
+    const auto end = Clock::now();
 
-                        const int neighbourPox_X = cellPosX + neighbourIndex_X;
-                        const int neighbourPos_Y = cellPosY + neighbourIndex_Y;
+    if (!engine.AllocatesInStep()) {
+        AssertNoAllocationsSince(allocationCount, "Engine::Step()");
+    }
 
-                        const State neighbourState = GetCellState(buffer, { neighbourPox_X, neighbourPos_Y });
+    // Make sure the final generation is observable so the steps can't be skipped.
+    engine.Store(grid);
+    const uint64_t nAliveCells = CountAliveCells(grid);
 
-                        if (neighbourState == State::ALIVE) {
-                            ++nAliveNeighbours;
-                        }
-                    }
-                }
-            }
+    const double seconds = std::chrono::duration<double>(end - start).count();
+    const uint64_t nGenerations = nSteps * engine.GenerationsPerStep();
+    const double nCellUpdates = static_cast<double>(grid.width) * grid.height * static_cast<double>(nGenerations);
 
-            const State currentCellState = GetCellState(buffer, { cellPosX, cellPosY });
-            State newCellState = currentCellState;
+    std::cout << engine.Name() << ": " << nGenerations << " generations of " << grid.width << "x" << grid.height
+              << " in " << seconds * 1000.0 << " ms (" << (seconds * 1e9) / nCellUpdates << " ns/cell, "
+              << static_cast<double>(nGenerations) / seconds << " generations/s), " << nAliveCells << " cells alive\n";
+}
 
-            switch (currentCellState) {
-            case (State::ALIVE): {
-                if (nAliveNeighbours < 2 || 3 < nAliveNeighbours) {
-                    newCellState = State::DEAD; // Cell dies via underpopulation or overpopulation.
-                } else if (nAliveNeighbours == 2 || nAliveNeighbours == 3) {
-                    newCellState = State::ALIVE; // Cell is happy and remains alive :)
-                }
-                break;
+int RunAllocationCheck(const Options& options)
+{
+    if constexpr (!allocationCountingEnabled) {
+        std::cout << "Error: Allocations are only counted in debug builds, so --check-allocations can't check anything\n";
+        return EXIT_FAILURE;
+    }
+
+    CellGrid grid(options.width, options.height);
+    GenerateRandomCells(grid);
+
+    // The vertices the quad renderer derives from each generation, the render loop's share of the work off the GPU.
+    std::vector<Vertex> vertices = CreateCellVertices(grid, 1.0f);
+
+    int nFailedEngines = 0;
+    const std::string names(EngineNames());
+    size_t begin = 0;
+    while (begin < names.size()) {
+        const size_t end = std::min(names.find(' ', begin), names.size());
+        Options engineOptions = options;
+        engineOptions.engine = names.substr(begin, end - begin);
+        begin = end + 1;
+
+        // GPU engines need a context, and the driver allocates as it queues their commands.
+        if (EngineNeedsOpenGL(engineOptions)) {
+            continue;
+        }
+
+        std::unique_ptr<Engine> engine = CreateEngine(engineOptions, options.width, options.height);
+        if (engine->AllocatesInStep()) {
+            std::cout << engine->Name() << ": skipped, its data structures grow with the pattern\n";
+            continue;
+        }
+
+        // Only the steady state counts, so the first round of each may set things up.
+        engine->Load(grid);
+        engine->Step();
+        engine->Store(grid);
+        UpdateCellVertices(grid, vertices);
+
+        const uint64_t beforeSteps = AllocationCount();
+        for (int step = 0; step < options.allocationCheckSteps; ++step) {
+            engine->Step();
+            engine->Store(grid);
+            UpdateCellVertices(grid, vertices);
+        }
+        const uint64_t nStepAllocations = AllocationCount() - beforeSteps;
+
+        const uint64_t beforeLoad = AllocationCount();
+        engine->Load(grid);
+        const uint64_t nLoadAllocations = AllocationCount() - beforeLoad;
+
+        const bool failed = nStepAllocations != 0 || nLoadAllocations != 0;
+        nFailedEngines += failed ? 1 : 0;
+        std::cout << engine->Name() << ": " << (failed ? "FAILED, " : "ok, ") << nStepAllocations << " allocation(s) in "
+                  << options.allocationCheckSteps << " rounds of stepping, storing and updating vertices, " << nLoadAllocations
+                  << " in loading\n";
+    }
+
+    const uint64_t nRenderAllocations = CountRenderAllocations(options, grid);
+    const bool renderFailed = nRenderAllocations != 0;
+    std::cout << RendererName(options.renderer) << " renderer: " << (renderFailed ? "FAILED, " : "ok, ") << nRenderAllocations
+              << " allocation(s) in " << options.allocationCheckSteps << " frames\n";
+
+    return nFailedEngines == 0 && !renderFailed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+uint64_t CountRenderAllocations(const Options& options, const CellGrid& grid)
+{
+    // Only hidden, so this still needs a display. The renderer is set up as the render loop does it.
+    const WindowLayout layout = CreateWindowLayout(options);
+    GLFWwindow* window = nullptr;
+    Initialize(window, layout, false);
+
+    const size_t nCells = static_cast<size_t>(grid.width) * static_cast<size_t>(grid.height);
+    const uint32_t VAO = CreateVAO();
+    std::vector<uint32_t> cellIndices;
+    std::vector<Vertex> cellVertices;
+    uint32_t cellTexture = 0;
+    uint32_t stateBuffer = 0;
+    if (options.renderer == Renderer::QUADS) {
+        CreateVBO(nCells);
+        cellIndices = CreateIBO(nCells);
+        SpecifyLayout();
+        cellVertices = CreateCellVertices(grid, layout.cellSize);
+    } else if (options.renderer == Renderer::TEXTURE) {
+        cellTexture = CreateCellTexture(grid.width, grid.height);
+    } else {
+        stateBuffer = CreateInstanceBuffers(grid);
+    }
+    const uint32_t shader = CreateShader(RendererShaderPath(options.renderer));
+
+    // Every frame uploads the grid as if a new generation had arrived.
+    const auto drawFrame = [&] {
+        if (options.renderer == Renderer::QUADS) {
+            Render(window, VAO, grid, true, cellVertices, cellIndices, shader);
+        } else if (options.renderer == Renderer::TEXTURE) {
+            RenderTexture(window, grid, true, cellTexture, shader);
+        } else {
+            RenderInstanced(window, grid, true, stateBuffer, shader, layout.cellSize);
+        }
+    };
+
+    // As in the render loop, the first frame may allocate.
+    drawFrame();
+    const uint64_t allocationCount = AllocationCount();
+    for (int frame = 0; frame < options.allocationCheckSteps; ++frame) {
+        drawFrame();
+    }
+    const uint64_t nAllocations = AllocationCount() - allocationCount;
+
+    // Not Exit(), which ends the program before the result is reported.
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return nAllocations;
+}
+
+
+void RunGpuGame(GLFWwindow* window, GpuEngine& engine, CellGrid& grid, const Options& options)
+{
+    using Clock = std::chrono::steady_clock;
+
+    // The engine can only be stepped where its context is current, so steps are paced here between frames
+    // rather than on a simulation thread. Frames that fall behind run several steps, up to a limit.
+    constexpr int maxStepsPerFrame = 64;
+    const Clock::duration period = options.generationsPerSecond == 0
+        ? Clock::duration::zero()
+        : std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / options.generationsPerSecond));
+    Clock::time_point deadline = Clock::now();
+
+    FrameScheduler scheduler(std::chrono::microseconds(options.frameBudgetMicroseconds));
+
+    uint64_t generation = 0;
+    uint64_t nSteps = 0;
+    bool restartKeyDown = false;
+    bool saveKeyDown = false;
+
+    while (!glfwWindowShouldClose(window)) {
+        int nStepsThisFrame = 0;
+        while (nStepsThisFrame < maxStepsPerFrame && (period == Clock::duration::zero() || Clock::now() >= deadline)) {
+            engine.Step();
+            generation += engine.GenerationsPerStep();
+            ++nStepsThisFrame;
+
+            if (options.printStatistics && ++nSteps % options.statisticsInterval == 0) {
+                engine.ReportStatistics(std::cout);
             }
-            case (State::DEAD): {
-                if (nAliveNeighbours == 3) {
-                    newCellState = State::ALIVE; // Cells reproduce to create an alive cell.
-                }
+
+            // With no rate to keep to, one step a frame is as fast as the display can show them.
+            if (period == Clock::duration::zero()) {
                 break;
             }
-            }
+            deadline += period;
+        }
+        if (period != Clock::duration::zero() && deadline < Clock::now()) {
+            deadline = Clock::now();
+        }
+
+        int windowWidth = 0;
+        int windowHeight = 0;
+        glfwGetFramebufferSize(window, &windowWidth, &windowHeight);
+        glViewport(0, 0, windowWidth, windowHeight);
+        engine.Draw(windowWidth, windowHeight);
 
-            const auto tempCell = CreateCell({ { cellPosX, cellPosY }, newCellState });
-            tempBuffer.insert(tempBuffer.end(), tempCell.begin(), tempCell.end());
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+
+        // Space restarts the game and S saves the generation on screen, as with the other engines.
+        if (KeyPressed(window, GLFW_KEY_SPACE, restartKeyDown)) {
+            GenerateRandomCells(grid);
+            engine.Load(grid);
+            generation = 0;
+        }
+        if (KeyPressed(window, GLFW_KEY_S, saveKeyDown)) {
+            engine.Store(grid);
+            const std::string path = "generation-" + std::to_string(generation) + ".cells";
+            scheduler.Spawn(WritePatternFile(scheduler, grid, generation, path));
         }
+        scheduler.RunFrame();
     }
 
-    // Update buffer with the updated cell states.
-    buffer = std::move(tempBuffer);
+    if (options.printStatistics) {
+        scheduler.ReportStatistics(std::cout);
+    }
 }
-
-void RestartGame(std::vector<Vertex>& buffer)
-{
-    buffer.erase(buffer.begin(), buffer.end());
-    GenerateRandomCells(buffer);
-}
\ No newline at end of file
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "engine.hpp"
+
+// ------------------
+// GPU Engines
+// ------------------
+
+// Engines whose cells stay in GPU memory. Load() and Store() are the only times cells cross the bus; the game is drawn
+// straight from the engine's own buffers. Every call must be made on the thread the OpenGL context is current on,
+// so these engines step on the render thread rather than the simulation thread.
+class GpuEngine : public Engine {
+public:
+    // Draw the cells over the whole of the current viewport, which is viewportWidth by viewportHeight pixels.
+    virtual void Draw(int viewportWidth, int viewportHeight) = 0;
+
+    // The driver allocates as it queues commands, which the allocation count can't tell apart from the engine.
+    bool AllocatesInStep() const override { return true; }
+};
@@ -0,0 +1,370 @@
+#include "hashlife.hpp"
+
+#include "lookuptable.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+namespace {
+    // The universe is kept well inside the range of int64_t coordinates.
+    constexpr int maxLevel = 60;
+
+    constexpr size_t initialBuckets = size_t(1) << 16;
+
+    inline size_t HashChildren(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se)
+    {
+        uint64_t hash = (static_cast<uint64_t>(nw) * 0x9E3779B97F4A7C15) ^ ne;
+        hash = (hash * 0x9E3779B97F4A7C15) ^ sw;
+        hash = (hash * 0x9E3779B97F4A7C15) ^ se;
+        return static_cast<size_t>(hash ^ (hash >> 29));
+    }
+}
+
+HashLifeEngine::HashLifeEngine(int m_width, int m_height, int m_stepLog, size_t memoryBudget)
+    : width(m_width)
+    , height(m_height)
+    , stepLog(m_stepLog)
+{
+    // Each node also takes about two buckets of the hash table.
+    maxNodes = std::max<size_t>(memoryBudget / (sizeof(Node) + (2 * sizeof(NodeId))), 1024);
+
+    Reset();
+}
+
+void HashLifeEngine::Reset()
+{
+    nodes.clear();
+    freeNodes.clear();
+    emptyNodes.clear();
+    buckets.assign(initialBuckets, noNode);
+
+    // The two level 0 nodes are never looked up through the hash table.
+    Node deadCell;
+    Node aliveCell;
+    aliveCell.population = 1;
+    nodes.push_back(deadCell);
+    nodes.push_back(aliveCell);
+    nLiveNodes = nodes.size();
+
+    emptyNodes.push_back(0);
+}
+
+HashLifeEngine::NodeId HashLifeEngine::Allocate()
+{
+    if (!freeNodes.empty()) {
+        const NodeId id = freeNodes.back();
+        freeNodes.pop_back();
+        return id;
+    }
+
+    nodes.emplace_back();
+    return static_cast<NodeId>(nodes.size() - 1);
+}
+
+void HashLifeEngine::InsertIntoHashTable(NodeId id)
+{
+    const Node& node = nodes[id];
+    const size_t mask = buckets.size() - 1;
+
+    size_t bucket = HashChildren(node.nw, node.ne, node.sw, node.se) & mask;
+    while (buckets[bucket] != noNode) {
+        bucket = (bucket + 1) & mask;
+    }
+    buckets[bucket] = id;
+}
+
+void HashLifeEngine::GrowHashTable()
+{
+    buckets.assign(buckets.size() * 2, noNode);
+
+    for (NodeId id = 2; id < nodes.size(); ++id) {
+        if (nodes[id].level != freeLevel) {
+            InsertIntoHashTable(id);
+        }
+    }
+}
+
+HashLifeEngine::NodeId HashLifeEngine::Make(NodeId nw, NodeId ne, NodeId sw, NodeId se)
+{
+    const size_t mask = buckets.size() - 1;
+
+    size_t bucket = HashChildren(nw, ne, sw, se) & mask;
+    while (buckets[bucket] != noNode) {
+        const Node& node = nodes[buckets[bucket]];
+        if (node.nw == nw && node.ne == ne && node.sw == sw && node.se == se) {
+            return buckets[bucket];
+        }
+        bucket = (bucket + 1) & mask;
+    }
+
+    // Allocate() may reallocate nodes, so the children are only read through their ids from here on.
+    const NodeId id = Allocate();
+    Node& node = nodes[id];
+    node.nw = nw;
+    node.ne = ne;
+    node.sw = sw;
+    node.se = se;
+    node.population = nodes[nw].population + nodes[ne].population + nodes[sw].population + nodes[se].population;
+    node.result = noNode;
+    node.level = nodes[nw].level + 1;
+    node.marked = false;
+
+    buckets[bucket] = id;
+    ++nLiveNodes;
+
+    // Keep the table at most half full so probe sequences stay short.
+    if (nLiveNodes * 2 > buckets.size()) {
+        GrowHashTable();
+    }
+
+    return id;
+}
+
+HashLifeEngine::NodeId HashLifeEngine::Empty(int level)
+{
+    while (static_cast<int>(emptyNodes.size()) <= level) {
+        const NodeId child = emptyNodes.back();
+        emptyNodes.push_back(Make(child, child, child, child));
+    }
+
+    return emptyNodes[level];
+}
+
+// ------------------
+// Moving cells in and out
+// ------------------
+
+HashLifeEngine::NodeId HashLifeEngine::Build(const CellGrid& grid, int level, int64_t x, int64_t y)
+{
+    const int64_t size = int64_t(1) << level;
+    if (x >= grid.width || y >= grid.height || x + size <= 0 || y + size <= 0) {
+        return Empty(level);
+    }
+
+    if (level == 0) {
+        return static_cast<NodeId>(GetCellState(grid, static_cast<int>(x), static_cast<int>(y)));
+    }
+
+    const int64_t half = size / 2;
+    const NodeId nw = Build(grid, level - 1, x, y);
+    const NodeId ne = Build(grid, level - 1, x + half, y);
+    const NodeId sw = Build(grid, level - 1, x, y + half);
+    const NodeId se = Build(grid, level - 1, x + half, y + half);
+
+    return Make(nw, ne, sw, se);
+}
+
+void HashLifeEngine::Load(const CellGrid& grid)
+{
+    Reset();
+
+    // The smallest square that covers the grid, and has room to be stepped.
+    int level = 3;
+    while ((int64_t(1) << level) < std::max(grid.width, grid.height)) {
+        ++level;
+    }
+
+    root = Build(grid, level, 0, 0);
+    rootX = 0;
+    rootY = 0;
+}
+
+void HashLifeEngine::Fill(CellGrid& grid, NodeId id, int64_t x, int64_t y) const
+{
+    const Node& node = nodes[id];
+    const int64_t size = int64_t(1) << node.level;
+
+    // Only descend into parts of the universe that are inside the view and have something to draw.
+    if (node.population == 0 || x >= grid.width || y >= grid.height || x + size <= 0 || y + size <= 0) {
+        return;
+    }
+
+    if (node.level == 0) {
+        SetCellState(grid, static_cast<int>(x), static_cast<int>(y), State::ALIVE);
+        return;
+    }
+
+    const int64_t half = size / 2;
+    Fill(grid, node.nw, x, y);
+    Fill(grid, node.ne, x + half, y);
+    Fill(grid, node.sw, x, y + half);
+    Fill(grid, node.se, x + half, y + half);
+}
+
+void HashLifeEngine::Store(CellGrid& grid) const
+{
+    std::fill(grid.cells.begin(), grid.cells.end(), 0);
+    Fill(grid, root, rootX, rootY);
+}
+
+// ------------------
+// Stepping
+// ------------------
+
+HashLifeEngine::NodeId HashLifeEngine::Centre(NodeId id)
+{
+    const Node node = nodes[id];
+    return Make(nodes[node.nw].se, nodes[node.ne].sw, nodes[node.sw].ne, nodes[node.se].nw);
+}
+
+HashLifeEngine::NodeId HashLifeEngine::Successor(NodeId id)
+{
+    // Copied, as making nodes below may reallocate the node storage.
+    const Node node = nodes[id];
+
+    if (node.result != noNode) {
+        return node.result;
+    }
+
+    NodeId result = noNode;
+
+    if (node.population == 0) {
+        result = Empty(node.level - 1);
+    } else if (node.level == 2) {
+        // Pack the 4x4 cells into a block table key, with the cell at (x, y) in bit (x * 4) + y.
+        auto quadrantBits = [&](NodeId quadrant, int x, int y) {
+            const Node& cells = nodes[quadrant];
+            return (cells.nw << ((x * 4) + y)) | (cells.ne << (((x + 1) * 4) + y))
+                | (cells.sw << ((x * 4) + y + 1)) | (cells.se << (((x + 1) * 4) + y + 1));
+        };
+        const uint32_t key = quadrantBits(node.nw, 0, 0) | quadrantBits(node.ne, 2, 0)
+            | quadrantBits(node.sw, 0, 2) | quadrantBits(node.se, 2, 2);
+
+        const uint8_t centre = blockTable[key];
+        result = Make(centre & 1, (centre >> 2) & 1, (centre >> 1) & 1, (centre >> 3) & 1);
+    } else {
+        const Node nw = nodes[node.nw];
+        const Node ne = nodes[node.ne];
+        const Node sw = nodes[node.sw];
+        const Node se = nodes[node.se];
+
+        // Nine overlapping sub-nodes, each half the size of this node, stepped forward.
+        const NodeId n00 = Successor(node.nw);
+        const NodeId n01 = Successor(Make(nw.ne, ne.nw, nw.se, ne.sw));
+        const NodeId n02 = Successor(node.ne);
+        const NodeId n10 = Successor(Make(nw.sw, nw.se, sw.nw, sw.ne));
+        const NodeId n11 = Successor(Make(nw.se, ne.sw, sw.ne, se.nw));
+        const NodeId n12 = Successor(Make(ne.sw, ne.se, se.nw, se.ne));
+        const NodeId n20 = Successor(node.sw);
+        const NodeId n21 = Successor(Make(sw.ne, se.nw, sw.se, se.sw));
+        const NodeId n22 = Successor(node.se);
+
+        const NodeId quadrantNW = Make(n00, n01, n10, n11);
+        const NodeId quadrantNE = Make(n01, n02, n11, n12);
+        const NodeId quadrantSW = Make(n10, n11, n20, n21);
+        const NodeId quadrantSE = Make(n11, n12, n21, n22);
+
+        if (stepLog >= node.level - 2) {
+            // Full speed: step the four quadrants again, for 2^(level - 2) generations in total.
+            result = Make(Successor(quadrantNW), Successor(quadrantNE), Successor(quadrantSW), Successor(quadrantSE));
+        } else {
+            // The sub-nodes have already been stepped by 2^stepLog generations, so only their centres are kept.
+            result = Make(Centre(quadrantNW), Centre(quadrantNE), Centre(quadrantSW), Centre(quadrantSE));
+        }
+    }
+
+    nodes[id].result = result;
+    return result;
+}
+
+bool HashLifeEngine::BorderIsEmpty() const
+{
+    const Node& node = nodes[root];
+    const uint64_t centrePopulation = nodes[nodes[node.nw].se].population + nodes[nodes[node.ne].sw].population
+        + nodes[nodes[node.sw].ne].population + nodes[nodes[node.se].nw].population;
+
+    return node.population == centrePopulation;
+}
+
+void HashLifeEngine::Expand()
+{
+    const Node node = nodes[root];
+    const NodeId empty = Empty(node.level - 1);
+
+    // Surround the root with empty space, keeping it in the centre of the new root.
+    root = Make(Make(empty, empty, empty, node.nw), Make(empty, empty, node.ne, empty),
+        Make(empty, node.sw, empty, empty), Make(node.se, empty, empty, empty));
+
+    const int64_t quarter = int64_t(1) << (node.level - 1);
+    rootX -= quarter;
+    rootY -= quarter;
+}
+
+void HashLifeEngine::Step()
+{
+    if (nLiveNodes > maxNodes) {
+        CollectGarbage();
+    }
+
+    // The successor of the root covers its centre half, so everything alive must be well inside it. Once the
+    // border is empty, one more expansion leaves 2^(level - 3) cells of margin, which is as far as
+    // anything can travel in the 2^stepLog generations.
+    while (nodes[root].level < stepLog + 2 || !BorderIsEmpty()) {
+        Expand();
+    }
+    Expand();
+
+    if (nodes[root].level > maxLevel) {
+        std::cout << "Error: The HashLife universe has grown past 2^" << maxLevel << " cells across, and cannot be stepped further\n";
+        return;
+    }
+
+    const int64_t quarter = int64_t(1) << (nodes[root].level - 2);
+    root = Successor(root);
+    rootX += quarter;
+    rootY += quarter;
+}
+
+// ------------------
+// Garbage Collection
+// ------------------
+
+void HashLifeEngine::Mark(NodeId id)
+{
+    Node& node = nodes[id];
+    if (node.marked || node.level == 0) {
+        return;
+    }
+
+    node.marked = true;
+    Mark(node.nw);
+    Mark(node.ne);
+    Mark(node.sw);
+    Mark(node.se);
+}
+
+void HashLifeEngine::CollectGarbage()
+{
+    // Memoised results are what keeps most old nodes reachable, so they are all dropped; the ones still
+    // needed are recomputed from the hash-consed nodes that survive.
+    for (Node& node : nodes) {
+        node.result = noNode;
+        node.marked = false;
+    }
+
+    Mark(root);
+    for (const NodeId empty : emptyNodes) {
+        Mark(empty);
+    }
+
+    freeNodes.clear();
+    nLiveNodes = 2;
+    std::fill(buckets.begin(), buckets.end(), noNode);
+
+    for (NodeId id = 2; id < nodes.size(); ++id) {
+        Node& node = nodes[id];
+
+        if (node.marked) {
+            node.marked = false;
+            InsertIntoHashTable(id);
+            ++nLiveNodes;
+        } else {
+            node.level = freeLevel;
+            freeNodes.push_back(id);
+        }
+    }
+
+    if (nLiveNodes > maxNodes) {
+        std::cout << "Warning: The HashLife pattern needs " << nLiveNodes << " nodes, more than the memory budget of " << maxNodes << "\n";
+    }
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "cellgrid.hpp"
+#include "engine.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// ------------------
+// HashLife
+// ------------------
+
+// Unbounded universe stored as a quadtree of hash-consed nodes, so identical regions are only stored,
+// and only ever stepped, once. Each Step() advances 2^stepLog generations.
+// The CellGrid passed to Load() and Store() is a view of the universe with its corner at (0, 0);
+// cells that leave the view keep evolving outside of it.
+class HashLifeEngine : public Engine {
+public:
+    // Once more than memoryBudget bytes of nodes are in use, unreachable nodes and memoised results are freed.
+    HashLifeEngine(int width, int height, int stepLog, size_t memoryBudget);
+
+    std::string_view Name() const override { return "hashlife"; }
+    void Load(const CellGrid& grid) override;
+    void Store(CellGrid& grid) const override;
+    void Step() override;
+
+    uint64_t GenerationsPerStep() const override { return uint64_t(1) << stepLog; }
+    bool AllocatesInStep() const override { return true; }
+
+private:
+    using NodeId = uint32_t;
+    static constexpr NodeId noNode = UINT32_MAX;
+
+    // Nodes at level n are squares of 2^n cells. Level 0 nodes are single cells: node 0 is dead and node 1 is alive.
+    // Children are in local coordinates, with x growing to the east and y to the south.
+    struct Node {
+        NodeId nw = 0;
+        NodeId ne = 0;
+        NodeId sw = 0;
+        NodeId se = 0;
+        uint64_t population = 0;
+
+        // The centre half of the node, 2^min(stepLog, level - 2) generations later. noNode until it is needed.
+        NodeId result = noNode;
+
+        uint8_t level = 0;
+        bool marked = false;
+    };
+
+    // Level of nodes on the free list.
+    static constexpr uint8_t freeLevel = UINT8_MAX;
+
+    int width = 0;
+    int height = 0;
+    int stepLog = 0;
+    size_t maxNodes = 0;
+
+    std::vector<Node> nodes;
+    std::vector<NodeId> freeNodes;
+    size_t nLiveNodes = 0;
+
+    // Open addressing hash table from children to node, so that every distinct node exists only once.
+    std::vector<NodeId> buckets;
+
+    // The empty node at each level.
+    std::vector<NodeId> emptyNodes;
+
+    NodeId root = 0;
+
+    // Universe coordinates of the root's north-west corner.
+    int64_t rootX = 0;
+    int64_t rootY = 0;
+
+    void Reset();
+    NodeId Make(NodeId nw, NodeId ne, NodeId sw, NodeId se);
+    NodeId Allocate();
+    void InsertIntoHashTable(NodeId id);
+    void GrowHashTable();
+    NodeId Empty(int level);
+
+    NodeId Build(const CellGrid& grid, int level, int64_t x, int64_t y);
+    void Fill(CellGrid& grid, NodeId id, int64_t x, int64_t y) const;
+
+    NodeId Centre(NodeId id);
+    NodeId Successor(NodeId id);
+    bool BorderIsEmpty() const;
+    void Expand();
+
+    void CollectGarbage();
+    void Mark(NodeId id);
+};
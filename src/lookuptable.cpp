@@ -0,0 +1,88 @@
+#include "lookuptable.hpp"
+
+#include <algorithm>
+#include <utility>
+
+constexpr std::array<uint8_t, 65536> blockTable = CreateBlockTable();
+
+// A vertical blinker in column 1 turns horizontal, leaving only its centre in the 2x2 centre block.
+static_assert(blockTable[0b0000'0000'0111'0000] == 0b0101);
+// The 2x2 centre block on its own is a still life.
+static_assert(blockTable[0b0000'0110'0110'0000] == 0b1111);
+
+LookupTableEngine::LookupTableEngine(int m_width, int m_height)
+    : width(m_width)
+    , height(m_height)
+    , nBlockColumns((m_width + 1) / 2)
+    , nBlockRows((m_height + 1) / 2)
+{
+    stride = (nBlockColumns * 2) + 2;
+
+    const size_t nCells = static_cast<size_t>(stride) * ((nBlockRows * 2) + 2);
+    cells.assign(nCells, 0);
+    nextCells.assign(nCells, 0);
+}
+
+void LookupTableEngine::Load(const CellGrid& grid)
+{
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            cells[Index(x, y)] = static_cast<uint8_t>(GetCellState(grid, x, y));
+        }
+    }
+}
+
+void LookupTableEngine::Store(CellGrid& grid) const
+{
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            SetCellState(grid, x, y, static_cast<State>(cells[Index(x, y)]));
+        }
+    }
+}
+
+void LookupTableEngine::Step()
+{
+    for (int blockRow = 0; blockRow < nBlockRows; ++blockRow) {
+        // The four rows of the 4x4 blocks, starting one above the block row. Row 0 of the buffer is the top border.
+        const uint8_t* row0 = &cells[static_cast<size_t>(blockRow * 2) * stride];
+        const uint8_t* row1 = row0 + stride;
+        const uint8_t* row2 = row1 + stride;
+        const uint8_t* row3 = row2 + stride;
+
+        uint8_t* nextRow0 = &nextCells[Index(0, blockRow * 2)];
+        uint8_t* nextRow1 = nextRow0 + stride;
+
+        auto column = [&](int x) {
+            return static_cast<uint32_t>(row0[x] | (row1[x] << 1) | (row2[x] << 2) | (row3[x] << 3));
+        };
+
+        // The key is built up a column at a time. Moving one block right drops the two oldest columns
+        // from the bottom of the key and adds two new ones to the top.
+        uint32_t key = column(0) | (column(1) << 4);
+        for (int blockColumn = 0; blockColumn < nBlockColumns; ++blockColumn) {
+            const int x = blockColumn * 2;
+            key |= (column(x + 2) << 8) | (column(x + 3) << 12);
+
+            const uint8_t centre = blockTable[key];
+            nextRow0[x] = centre & 1;
+            nextRow1[x] = (centre >> 1) & 1;
+            nextRow0[x + 1] = (centre >> 2) & 1;
+            nextRow1[x + 1] = (centre >> 3) & 1;
+
+            key >>= 8;
+        }
+    }
+
+    // Rounding up to whole blocks may have added a column or row past the grid, whose cells must stay dead.
+    if (width % 2 != 0) {
+        for (int y = 0; y < height; ++y) {
+            nextCells[Index(width, y)] = 0;
+        }
+    }
+    if (height % 2 != 0) {
+        std::fill_n(&nextCells[Index(0, height)], width, 0);
+    }
+
+    std::swap(cells, nextCells);
+}
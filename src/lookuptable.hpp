@@ -0,0 +1,84 @@
+#pragma once
+
+#include "cellgrid.hpp"
+#include "engine.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// ------------------
+// Block Lookup Table
+// ------------------
+
+// B3/S23: bit n is set if a cell with n live neighbours is born / survives.
+constexpr uint16_t birthRule = 1 << 3;
+constexpr uint16_t survivalRule = (1 << 2) | (1 << 3);
+
+// Number of set bits, cheap enough to evaluate 65536 * 4 times at compile time.
+constexpr int CountBits(uint32_t bits)
+{
+    bits = bits - ((bits >> 1) & 0x55555555);
+    bits = (bits & 0x33333333) + ((bits >> 2) & 0x33333333);
+    bits = (bits + (bits >> 4)) & 0x0F0F0F0F;
+    return static_cast<int>((bits * 0x01010101) >> 24);
+}
+
+// A 4x4 block of cells is packed into a 16-bit key with the cell at (column, row) in bit (column * 4) + row.
+// The table maps each key to the next generation of the 2x2 centre of the block, with the cell at
+// (column + 1, row + 1) in bit (column * 2) + row.
+constexpr std::array<uint8_t, 65536> CreateBlockTable()
+{
+    // 3x3 neighbourhood of the centre cell at (1, 1), not including the cell itself.
+    constexpr uint32_t neighbourhood = 0b0111'0101'0111;
+
+    std::array<uint8_t, 65536> table {};
+
+    for (uint32_t key = 0; key < table.size(); ++key) {
+        uint8_t centre = 0;
+
+        for (int column = 1; column <= 2; ++column) {
+            for (int row = 1; row <= 2; ++row) {
+                const int cellBit = (column * 4) + row;
+
+                // Move the neighbourhood from around (1, 1) to around (column, row).
+                const int nAliveNeighbours = CountBits(key & (neighbourhood << (cellBit - 5)));
+                const uint16_t rule = ((key >> cellBit) & 1) ? survivalRule : birthRule;
+
+                centre |= ((rule >> nAliveNeighbours) & 1) << (((column - 1) * 2) + (row - 1));
+            }
+        }
+
+        table[key] = centre;
+    }
+
+    return table;
+}
+
+// Generated at compile time by CreateBlockTable().
+extern const std::array<uint8_t, 65536> blockTable;
+
+// Steps each 2x2 block of cells with a single lookup of its surrounding 4x4 block in blockTable, without branching on cell states.
+class LookupTableEngine : public Engine {
+public:
+    LookupTableEngine(int width, int height);
+
+    std::string_view Name() const override { return "lookup"; }
+    void Load(const CellGrid& grid) override;
+    void Store(CellGrid& grid) const override;
+    void Step() override;
+
+private:
+    int width = 0;
+    int height = 0;
+
+    // The grid is rounded up to whole 2x2 blocks and surrounded by a border of dead cells.
+    int stride = 0;
+    int nBlockColumns = 0;
+    int nBlockRows = 0;
+
+    std::vector<uint8_t> cells;
+    std::vector<uint8_t> nextCells;
+
+    size_t Index(int x, int y) const { return (static_cast<size_t>(y + 1) * stride) + (x + 1); }
+};
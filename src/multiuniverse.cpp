@@ -0,0 +1,219 @@
+#include "multiuniverse.hpp"
+
+#include "bitboard.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <ostream>
+#include <utility>
+
+namespace {
+    // Counts the live cells of all 64 universes at once, with bit-sliced counters: bit n of counter[b] is bit b of
+    // universe n's count, so adding a word of cells is a ripple carry through the counter's bits.
+    class PopulationCounter {
+    public:
+        void Add(uint64_t word)
+        {
+            // The small counter's fixed ripple compiles to straight-line code. It is flushed into the wide counter,
+            // whose ripple branches, just before it can overflow.
+            for (int bit = 0; bit < nSmallBits; ++bit) {
+                const uint64_t carry = smallCounter[bit] & word;
+                smallCounter[bit] ^= word;
+                word = carry;
+            }
+
+            if (++nSmallCounts == maxSmallCount) {
+                Flush();
+            }
+        }
+
+        std::array<uint64_t, MultiUniverseEngine::nUniverses> Populations()
+        {
+            Flush();
+
+            std::array<uint64_t, MultiUniverseEngine::nUniverses> populations {};
+            for (int universe = 0; universe < MultiUniverseEngine::nUniverses; ++universe) {
+                for (int bit = 0; bit < nBits; ++bit) {
+                    populations[universe] |= ((counter[bit] >> universe) & 1) << bit;
+                }
+            }
+
+            return populations;
+        }
+
+    private:
+        // Enough bits to count the cells of any grid.
+        static constexpr int nBits = 48;
+        static constexpr int nSmallBits = 4;
+        static constexpr int maxSmallCount = (1 << nSmallBits) - 1;
+
+        std::array<uint64_t, nBits> counter {};
+        std::array<uint64_t, nSmallBits> smallCounter {};
+        int nSmallCounts = 0;
+
+        void Flush()
+        {
+            for (int smallBit = 0; smallBit < nSmallBits; ++smallBit) {
+                uint64_t word = smallCounter[smallBit];
+                for (int bit = smallBit; word != 0 && bit < nBits; ++bit) {
+                    const uint64_t carry = counter[bit] & word;
+                    counter[bit] ^= word;
+                    word = carry;
+                }
+                smallCounter[smallBit] = 0;
+            }
+            nSmallCounts = 0;
+        }
+    };
+}
+
+MultiUniverseEngine::MultiUniverseEngine(int m_width, int m_height, uint64_t m_maxAge, uint64_t m_seed)
+    : width(m_width)
+    , height(m_height)
+    , stride(m_width + 2)
+    , maxAge(m_maxAge)
+    , seed(m_seed)
+    , randomState(m_seed)
+{
+    std::cout << "universes: soups seeded with " << seed << ", repeat them with --seed " << seed << "\n";
+
+    const size_t nWords = static_cast<size_t>(width + 2) * (height + 2);
+    cells.assign(nWords, 0);
+    previousCells.assign(nWords, 0);
+}
+
+uint64_t MultiUniverseEngine::NextRandom()
+{
+    // SplitMix64: fast, and good enough that neighbouring cells and universes get unrelated soups.
+    uint64_t value = (randomState += 0x9E3779B97F4A7C15);
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EB;
+    return value ^ (value >> 31);
+}
+
+std::array<uint64_t, MultiUniverseEngine::nUniverses> MultiUniverseEngine::Refill(uint64_t mask)
+{
+    // The final populations are counted in the same pass that overwrites the cells.
+    PopulationCounter counter;
+
+    for (int y = 0; y < height; ++y) {
+        uint64_t* row = Row(cells, y);
+        for (int x = 0; x < width; ++x) {
+            counter.Add(row[x] & mask);
+            row[x] = (row[x] & ~mask) | (NextRandom() & mask);
+        }
+    }
+
+    for (int universe = 0; universe < nUniverses; ++universe) {
+        if ((mask >> universe) & 1) {
+            ages[universe] = 0;
+        }
+    }
+
+    return counter.Populations();
+}
+
+std::array<uint64_t, MultiUniverseEngine::nUniverses> MultiUniverseEngine::Populations() const
+{
+    PopulationCounter counter;
+
+    for (int y = 0; y < height; ++y) {
+        const uint64_t* row = Row(cells, y);
+        for (int x = 0; x < width; ++x) {
+            counter.Add(row[x]);
+        }
+    }
+
+    return counter.Populations();
+}
+
+void MultiUniverseEngine::Load(const CellGrid& grid)
+{
+    Refill(~uint64_t(0));
+    std::fill(ages.begin(), ages.end(), 0);
+
+    for (int y = 0; y < height; ++y) {
+        uint64_t* row = Row(cells, y);
+        for (int x = 0; x < width; ++x) {
+            row[x] = (row[x] & ~uint64_t(1)) | static_cast<uint64_t>(GetCellState(grid, x, y));
+        }
+    }
+}
+
+void MultiUniverseEngine::Store(CellGrid& grid) const
+{
+    for (int y = 0; y < height; ++y) {
+        const uint64_t* row = Row(cells, y);
+        for (int x = 0; x < width; ++x) {
+            SetCellState(grid, x, y, static_cast<State>(row[x] & 1));
+        }
+    }
+}
+
+void MultiUniverseEngine::Step()
+{
+    // Universes with any cell that differs from two generations ago.
+    uint64_t changed = 0;
+
+    for (int y = 0; y < height; ++y) {
+        const uint64_t* above = Row(cells, y - 1);
+        const uint64_t* middle = Row(cells, y);
+        const uint64_t* below = Row(cells, y + 1);
+        uint64_t* next = Row(previousCells, y);
+
+        for (int x = 0; x < width; ++x) {
+            // Every neighbour is a whole word, already lined up bit for bit with the cell, so nothing is shifted.
+            const uint64_t cell = StepBitSlices(above[x - 1], above[x], above[x + 1],
+                middle[x - 1], middle[x], middle[x + 1],
+                below[x - 1], below[x], below[x + 1]);
+
+            changed |= cell ^ next[x];
+            next[x] = cell;
+        }
+    }
+
+    std::swap(cells, previousCells);
+
+    uint64_t settled = 0;
+    uint64_t expired = 0;
+    for (int universe = 0; universe < nUniverses; ++universe) {
+        // A refilled universe has nothing meaningful two generations back until it has been stepped twice.
+        const uint64_t age = ++ages[universe];
+        const uint64_t bit = uint64_t(1) << universe;
+
+        if (age >= 2 && (changed & bit) == 0) {
+            settled |= bit;
+            ++nSoupsSettled;
+            totalSettledAge += age;
+        } else if (age >= maxAge) {
+            expired |= bit;
+            ++nSoupsExpired;
+        }
+    }
+
+    if ((settled | expired) == 0) {
+        return;
+    }
+
+    const std::array<uint64_t, nUniverses> finalPopulations = Refill(settled | expired);
+    for (int universe = 0; universe < nUniverses; ++universe) {
+        if ((settled >> universe) & 1) {
+            totalSettledPopulation += finalPopulations[universe];
+        }
+    }
+}
+
+void MultiUniverseEngine::ReportStatistics(std::ostream& stream) const
+{
+    const double averageAge = nSoupsSettled == 0 ? 0.0 : static_cast<double>(totalSettledAge) / nSoupsSettled;
+    const double averagePopulation = nSoupsSettled == 0 ? 0.0 : static_cast<double>(totalSettledPopulation) / nSoupsSettled;
+
+    stream << "universes: " << nSoupsSettled << " soups settled after " << averageAge << " generations on average, with "
+           << averagePopulation << " cells left alive on average; " << nSoupsExpired << " reached " << maxAge << " generations without settling (seed "
+           << seed << ")\n";
+    stream << "  populations:";
+    for (const uint64_t population : Populations()) {
+        stream << " " << population;
+    }
+    stream << "\n";
+}
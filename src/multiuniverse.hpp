@@ -0,0 +1,69 @@
+#pragma once
+
+#include "cellgrid.hpp"
+#include "engine.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// ------------------
+// Multi-Universe
+// ------------------
+
+// Runs 64 independent soups on the same grid for soup statistics. Bit n of each cell's word belongs to universe n,
+// so one pass of the bitboard full-adder logic over the grid advances all 64 at once.
+//
+// Each generation also checks whether each universe is back to where it was two generations earlier, which means it
+// has settled into still lifes and period 2 oscillators for good. Settled universes, and those that reach maxAge
+// without settling, are retired and refilled with a new random soup, and their final populations recorded.
+class MultiUniverseEngine : public Engine {
+public:
+    static constexpr int nUniverses = 64;
+
+    // The soups are generated from seed, so the same seed gives the same run.
+    MultiUniverseEngine(int width, int height, uint64_t maxAge, uint64_t seed);
+
+    std::string_view Name() const override { return "universes"; }
+
+    // Universe 0 is loaded from, and stored to, the grid. The other universes are filled with random soups.
+    void Load(const CellGrid& grid) override;
+    void Store(CellGrid& grid) const override;
+    void Step() override;
+    void ReportStatistics(std::ostream& stream) const override;
+
+    // Live cells in each universe, counted for all 64 at once with bit-sliced counters.
+    std::array<uint64_t, nUniverses> Populations() const;
+
+private:
+    int width = 0;
+    int height = 0;
+
+    // Bytes from one row to the next, including the empty column either side. An empty row above and below the grid
+    // mean neighbour reads need no bounds checks.
+    int stride = 0;
+
+    // The current generation, and the one before it. Step() overwrites the older one in place with the next generation,
+    // reading each word before writing it, which is all it needs to compare the new generation with the old one.
+    std::vector<uint64_t> cells;
+    std::vector<uint64_t> previousCells;
+
+    uint64_t maxAge = 0;
+    std::array<uint64_t, nUniverses> ages {};
+
+    uint64_t seed = 0;
+    uint64_t randomState = 0;
+
+    uint64_t nSoupsSettled = 0;
+    uint64_t nSoupsExpired = 0;
+    uint64_t totalSettledAge = 0;
+    uint64_t totalSettledPopulation = 0;
+
+    uint64_t* Row(std::vector<uint64_t>& buffer, int y) { return buffer.data() + (static_cast<size_t>(y + 1) * stride) + 1; }
+    const uint64_t* Row(const std::vector<uint64_t>& buffer, int y) const { return buffer.data() + (static_cast<size_t>(y + 1) * stride) + 1; }
+
+    uint64_t NextRandom();
+
+    // Replace the universes whose bits are set in mask with new random soups. Returns their populations before the refill.
+    std::array<uint64_t, nUniverses> Refill(uint64_t mask);
+};
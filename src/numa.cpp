@@ -0,0 +1,122 @@
+#include "numa.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    // From linux/mempolicy.h: return the node of the page at the given address rather than the thread's policy.
+    constexpr unsigned long mpolFlagNode = 1 << 0;
+    constexpr unsigned long mpolFlagAddress = 1 << 1;
+
+    // Pages sampled from each band, enough to tell a band split across nodes without walking every page of a huge grid.
+    constexpr int nSamplesPerBand = 16;
+
+    // Bytes [first, second) of grid's cells that hold the thread's band of rows. The first and last bands
+    // include the halo rows above and below the grid.
+    std::pair<size_t, size_t> BandBytes(const CellGrid& grid, int thread, int nThreads)
+    {
+        const Band band = BandOf(grid.height, thread, nThreads);
+        const size_t begin = thread == 0 ? 0 : static_cast<size_t>(band.begin + 1) * grid.stride;
+        const size_t end = thread == nThreads - 1 ? grid.cells.size() : static_cast<size_t>(band.end + 1) * grid.stride;
+
+        return { begin, end };
+    }
+}
+
+int MemoryNode(const void* address)
+{
+#ifdef __linux__
+    // Called directly rather than through libnuma, which would be a dependency for a single syscall.
+    int node = -1;
+    if (syscall(SYS_get_mempolicy, &node, nullptr, 0, address, mpolFlagNode | mpolFlagAddress) == 0) {
+        return node;
+    }
+#endif
+    return -1;
+}
+
+bool PinCurrentThread(int cpuIndex)
+{
+#ifdef __linux__
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0 || CPU_COUNT(&allowed) == 0) {
+        return false;
+    }
+
+    int index = cpuIndex % CPU_COUNT(&allowed);
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (!CPU_ISSET(cpu, &allowed) || index-- != 0) {
+            continue;
+        }
+
+        cpu_set_t pinned;
+        CPU_ZERO(&pinned);
+        CPU_SET(cpu, &pinned);
+        return pthread_setaffinity_np(pthread_self(), sizeof(pinned), &pinned) == 0;
+    }
+#endif
+    return false;
+}
+
+void FirstTouchBands(ThreadPool& pool, CellGrid& grid)
+{
+    auto zeroBand = [&](int thread) {
+        const auto [begin, end] = BandBytes(grid, thread, pool.ThreadCount());
+        std::fill(grid.cells.begin() + begin, grid.cells.begin() + end, 0);
+    };
+    pool.Run(zeroBand);
+}
+
+void CopyBands(ThreadPool& pool, const CellGrid& source, CellGrid& destination)
+{
+    auto copyBand = [&](int thread) {
+        const auto [begin, end] = BandBytes(destination, thread, pool.ThreadCount());
+        std::copy(source.cells.begin() + begin, source.cells.begin() + end, destination.cells.begin() + begin);
+    };
+    pool.Run(copyBand);
+}
+
+void ReportBandNodes(std::ostream& stream, const CellGrid& grid, int nBands)
+{
+    const uint8_t* bytes = grid.cells.data();
+
+    stream << "NUMA nodes of " << nBands << " bands:";
+    for (int band = 0; band < nBands; ++band) {
+        const auto [begin, end] = BandBytes(grid, band, nBands);
+
+        // Nodes of the sampled pages, in order of first appearance, with -1 for pages whose node is unknown.
+        std::vector<int> nodes;
+        for (int sample = 0; sample < nSamplesPerBand && begin < end; ++sample) {
+            const int node = MemoryNode(bytes + begin + ((end - begin - 1) * sample) / (nSamplesPerBand - 1));
+
+            bool seen = false;
+            for (const int seenNode : nodes) {
+                seen = seen || seenNode == node;
+            }
+            if (!seen) {
+                nodes.push_back(node);
+            }
+        }
+
+        stream << " [band " << band << ":";
+        for (const int node : nodes) {
+            if (node < 0) {
+                stream << " unknown";
+            } else {
+                stream << " " << node;
+            }
+        }
+        stream << "]";
+    }
+    stream << "\n";
+}
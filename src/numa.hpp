@@ -0,0 +1,30 @@
+#pragma once
+
+#include "cellgrid.hpp"
+#include "threadpool.hpp"
+
+#include <ostream>
+
+// ------------------
+// NUMA Placement
+// ------------------
+
+// Linux places a page on the NUMA node of the CPU that first writes to it. Large grids are therefore first touched by
+// the thread that will step each part of them, with the thread pinned to a CPU so that it stays on that node.
+
+// NUMA node holding the page at address, or -1 if it can't be found, e.g. the page isn't mapped yet or this isn't Linux.
+int MemoryNode(const void* address);
+
+// Pin the calling thread to the cpuIndex-th CPU it is allowed to run on, wrapping around if there are fewer CPUs.
+// Returns false if pinning isn't supported or failed.
+bool PinCurrentThread(int cpuIndex);
+
+// Each thread of the pool zeroes the band of grid's rows it steps, placing those pages on its node.
+// grid should have been created with Allocation::UNTOUCHED.
+void FirstTouchBands(ThreadPool& pool, CellGrid& grid);
+
+// Copy source into destination, which has the same dimensions, with each thread copying its own band.
+void CopyBands(ThreadPool& pool, const CellGrid& source, CellGrid& destination);
+
+// Print which nodes the pages of each thread's band of grid are on.
+void ReportBandNodes(std::ostream& stream, const CellGrid& grid, int nBands);
@@ -0,0 +1,212 @@
+#include "options.hpp"
+
+#include "engine.hpp"
+
+#include <array>
+#include <cerrno>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <string_view>
+
+namespace {
+    // Each side is limited so that cell indices within a row, and row counts, fit in an int.
+    constexpr int maxGridSize = 1 << 24;
+    constexpr int maxThreads = 1024;
+    constexpr int maxTemporalDepth = 64;
+    constexpr int maxProcesses = 256;
+
+    // Indexed by Renderer.
+    constexpr std::array<std::string_view, 3> rendererNames = { "quads", "texture", "instanced" };
+
+    void PrintUsage(std::string_view program)
+    {
+        std::cout << "Usage: " << program << " [options]\n"
+                  << "  --width <cells>       Width of the grid (default: 250)\n"
+                  << "  --height <cells>      Height of the grid (default: 250)\n"
+                  << "  --window-size <px>    Length of the longest side of the window (default: 1000)\n"
+                  << "  --renderer <name>     How the window draws the cells: quads, texture or instanced (default: quads)\n"
+                  << "  --memory-budget <n>   MiB the grid may use for simulation and rendering (default: 4096)\n"
+                  << "  --engine <name>       Simulation engine, one of: " << EngineNames() << " (default: bytegrid)\n"
+                  << "  --edges <mode>        What lies past the edges of the grid: dead, toroidal or mirror (default: dead)\n"
+                  << "  --threads <n>         Threads for bytegrid, tiled and temporal, 0 for one per hardware thread (default: 0)\n"
+                  << "  --pin                 Pin each engine thread to its own CPU\n"
+                  << "  --adaptive-threads    Let bytegrid and tiled use fewer threads when there is little work\n"
+                  << "  --log-threads         Print each change --adaptive-threads makes to the thread count\n"
+                  << "  --numa-report         Print the NUMA node of each thread's band of the grid at startup\n"
+                  << "  --processes <n>       Worker processes for the processes engine (default: 4)\n"
+                  << "  --temporal-depth <k>  Generations the temporal engine advances per pass over the grid (default: 8)\n"
+                  << "  --isa <name>          Instruction set for the bytegrid kernel: scalar, sse2, avx2 or avx512 (default: best supported)\n"
+                  << "  --max-soup-age <n>    Generations before the universes engine gives up on a soup settling (default: 10000)\n"
+                  << "  --seed <n>            Seed of the universes engine's soups, to repeat a run (default: random)\n"
+                  << "  --hashlife-step <k>   HashLife advances 2^k generations per step (default: 0)\n"
+                  << "  --hashlife-memory <n> MiB of HashLife nodes to keep before collecting garbage (default: 512)\n"
+                  << "  --gps <n>             Generations per second, 0 for as fast as possible (default: 60)\n"
+                  << "  --stats               Print engine statistics every 60 steps, and after a benchmark\n"
+                  << "  --monitor <n>         Print the population every n generations from a separate consumer thread\n"
+                  << "  --stream-policy <p>   What the monitor's stream does when it falls behind: drop, block or coalesce (default: drop)\n"
+                  << "  --pattern <file>      Plaintext (.cells) pattern to load with the L key\n"
+                  << "  --frame-budget <us>   Microseconds per frame for saving, loading and shader reloads (default: 2000)\n"
+                  << "  --benchmark <n>       Run n steps without a window and report the timing\n"
+                  << "  --check-allocations <n> Step every CPU engine n times, draw n frames with --renderer in a hidden window,\n"
+                  << "                        and fail if any of it allocates (debug builds, GPU engines aren't checked)\n"
+                  << "  --help                Show this message\n";
+    }
+
+    [[noreturn]] void ExitWithUsage(std::string_view program, std::string_view error)
+    {
+        std::cout << "Error: " << error << "\n";
+        PrintUsage(program);
+        std::exit(EXIT_FAILURE);
+    }
+
+    int ParseInt(std::string_view program, std::string_view option, const char* value, int min, int max)
+    {
+        char* end = nullptr;
+        const long result = std::strtol(value, &end, 10);
+
+        if (end == value || *end != '\0' || result < min || result > max) {
+            ExitWithUsage(program, std::string(option) + " expects an integer from " + std::to_string(min) + " to " + std::to_string(max));
+        }
+
+        return static_cast<int>(result);
+    }
+
+    uint64_t ParseUnsigned(std::string_view program, std::string_view option, const char* value)
+    {
+        char* end = nullptr;
+        errno = 0;
+        const unsigned long long result = std::strtoull(value, &end, 10);
+
+        if (end == value || *end != '\0' || *value == '-' || errno == ERANGE) {
+            ExitWithUsage(program, std::string(option) + " expects an integer from 0 to " + std::to_string(std::numeric_limits<uint64_t>::max()));
+        }
+
+        return static_cast<uint64_t>(result);
+    }
+
+    int ParsePositiveInt(std::string_view program, std::string_view option, const char* value)
+    {
+        return ParseInt(program, option, value, 1, std::numeric_limits<int>::max());
+    }
+}
+
+std::string_view RendererName(Renderer renderer)
+{
+    return rendererNames[static_cast<int>(renderer)];
+}
+
+bool ParseRenderer(std::string_view name, Renderer& renderer)
+{
+    for (size_t index = 0; index < rendererNames.size(); ++index) {
+        if (name == rendererNames[index]) {
+            renderer = static_cast<Renderer>(index);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+Options ParseArguments(int argc, char** argv)
+{
+    Options options;
+    const std::string_view program = argv[0];
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view argument = argv[i];
+
+        if (argument == "--help") {
+            PrintUsage(program);
+            std::exit(EXIT_SUCCESS);
+        } else if (argument == "--stats") {
+            options.printStatistics = true;
+            continue;
+        } else if (argument == "--pin") {
+            options.pinThreads = true;
+            continue;
+        } else if (argument == "--numa-report") {
+            options.reportNodes = true;
+            continue;
+        } else if (argument == "--adaptive-threads") {
+            options.threadScaling.adaptive = true;
+            continue;
+        } else if (argument == "--log-threads") {
+            options.threadScaling.logDecisions = true;
+            continue;
+        }
+
+        // All other options take a value.
+        if (i + 1 >= argc) {
+            ExitWithUsage(program, std::string(argument) + " is not a valid option or is missing its value");
+        }
+        const char* value = argv[++i];
+
+        if (argument == "--width") {
+            options.width = ParseInt(program, argument, value, 1, maxGridSize);
+        } else if (argument == "--height") {
+            options.height = ParseInt(program, argument, value, 1, maxGridSize);
+        } else if (argument == "--window-size") {
+            options.windowSize = ParseInt(program, argument, value, 1, maxGridSize);
+        } else if (argument == "--renderer") {
+            Renderer renderer = Renderer::QUADS;
+            if (!ParseRenderer(value, renderer)) {
+                ExitWithUsage(program, std::string(value) + " is not a renderer");
+            }
+            options.renderer = renderer;
+        } else if (argument == "--memory-budget") {
+            options.memoryBudgetMiB = ParsePositiveInt(program, argument, value);
+        } else if (argument == "--engine") {
+            options.engine = value;
+        } else if (argument == "--edges") {
+            EdgeMode edgeMode = EdgeMode::DEAD;
+            if (!ParseEdgeMode(value, edgeMode)) {
+                ExitWithUsage(program, std::string(value) + " is not an edge mode");
+            }
+            options.edgeMode = edgeMode;
+        } else if (argument == "--threads") {
+            options.threads = ParseInt(program, argument, value, 0, maxThreads);
+        } else if (argument == "--processes") {
+            options.processes = ParseInt(program, argument, value, 1, maxProcesses);
+        } else if (argument == "--temporal-depth") {
+            options.temporalDepth = ParseInt(program, argument, value, 1, maxTemporalDepth);
+        } else if (argument == "--isa") {
+            InstructionSet instructionSet = InstructionSet::SCALAR;
+            if (!ParseInstructionSet(value, instructionSet)) {
+                ExitWithUsage(program, std::string(value) + " is not an instruction set");
+            }
+            options.instructionSet = instructionSet;
+        } else if (argument == "--max-soup-age") {
+            options.maxSoupAge = ParsePositiveInt(program, argument, value);
+        } else if (argument == "--seed") {
+            options.soupSeed = ParseUnsigned(program, argument, value);
+        } else if (argument == "--hashlife-step") {
+            options.hashLifeStepLog = ParseInt(program, argument, value, 0, 56);
+        } else if (argument == "--hashlife-memory") {
+            options.hashLifeMemoryMiB = ParsePositiveInt(program, argument, value);
+        } else if (argument == "--gps") {
+            options.generationsPerSecond = ParseInt(program, argument, value, 0, std::numeric_limits<int>::max());
+        } else if (argument == "--monitor") {
+            options.monitorInterval = ParsePositiveInt(program, argument, value);
+        } else if (argument == "--stream-policy") {
+            BackPressure backPressure = BackPressure::DROP;
+            if (!ParseBackPressure(value, backPressure)) {
+                ExitWithUsage(program, std::string(value) + " is not a stream policy");
+            }
+            options.streamBackPressure = backPressure;
+        } else if (argument == "--pattern") {
+            options.patternPath = value;
+        } else if (argument == "--frame-budget") {
+            options.frameBudgetMicroseconds = ParsePositiveInt(program, argument, value);
+        } else if (argument == "--benchmark") {
+            options.benchmarkSteps = ParsePositiveInt(program, argument, value);
+        } else if (argument == "--check-allocations") {
+            options.allocationCheckSteps = ParsePositiveInt(program, argument, value);
+        } else {
+            ExitWithUsage(program, std::string(argument) + " is not a valid option");
+        }
+    }
+
+    return options;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "cellgrid.hpp"
+#include "generationstream.hpp"
+#include "simdkernel.hpp"
+#include "threadcontroller.hpp"
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// ------------------
+// Command Line Options
+// ------------------
+
+// How the window draws the cells of engines that don't draw their own.
+enum class Renderer {
+    QUADS = 0, // A coloured square of four vertices per cell, indexed as two triangles.
+    TEXTURE = 1, // One byte per cell in a texture, looked up for each pixel of a full-screen triangle.
+    INSTANCED = 2 // One instance of a unit quad per cell, coloured by a byte of state per instance.
+};
+
+std::string_view RendererName(Renderer renderer);
+
+// Returns false if name isn't the name of a renderer.
+bool ParseRenderer(std::string_view name, Renderer& renderer);
+
+struct Options {
+    // Grid dimensions in cells, and the size in pixels of the longest side of the window.
+    int width = 250;
+    int height = 250;
+    int windowSize = 1000;
+    Renderer renderer = Renderer::QUADS;
+
+    // Startup fails if the grid would need more memory than this.
+    size_t memoryBudgetMiB = 4096;
+
+    std::string engine = "bytegrid";
+
+    // What lies past the edges of the grid. Only some engines support edge modes other than DEAD.
+    EdgeMode edgeMode = EdgeMode::DEAD;
+
+    // Worker processes the processes engine splits the grid between.
+    int processes = 4;
+
+    // Generations the temporal engine advances per pass over the grid.
+    int temporalDepth = 8;
+
+    // Threads the bytegrid, tiled and temporal engines step each generation on. 0 uses every hardware thread.
+    int threads = 0;
+
+    // Pin each of those threads to its own CPU, and print the NUMA node of each thread's band of the grid at startup.
+    bool pinThreads = false;
+    bool reportNodes = false;
+
+    // Whether bytegrid and tiled pick how many of those threads to use each generation, and log the changes.
+    ThreadScaling threadScaling;
+
+    // Overrides the instruction set picked through CPUID for the bytegrid kernel.
+    std::optional<InstructionSet> instructionSet;
+
+    // The universes engine gives up on a soup that hasn't settled after this many generations.
+    uint64_t maxSoupAge = 10000;
+
+    // Seed of the universes engine's soups. Without one, a seed is drawn from std::random_device and printed.
+    std::optional<uint64_t> soupSeed;
+
+    // HashLife advances 2^hashLifeStepLog generations per step, and collects garbage past its memory budget.
+    int hashLifeStepLog = 0;
+    size_t hashLifeMemoryMiB = 512;
+
+    // Generations the game advances per second, independently of the display's refresh rate. 0 runs as fast as possible.
+    int generationsPerSecond = 60;
+
+    // Print the engine's statistics every statisticsInterval steps while the game runs.
+    bool printStatistics = false;
+    int statisticsInterval = 60;
+
+    // Print the population every monitorInterval generations from a consumer of a generation stream, which applies
+    // streamBackPressure when the consumer falls behind. 0 attaches no consumer.
+    int monitorInterval = 0;
+    BackPressure streamBackPressure = BackPressure::DROP;
+
+    // Pattern the L key loads, in the plaintext format.
+    std::string patternPath;
+
+    // Microseconds per frame that tasks like writing snapshots, loading patterns and reloading the shader may take.
+    int frameBudgetMicroseconds = 2000;
+
+    // Run this many steps without a window and report the timing, instead of starting the game.
+    int benchmarkSteps = 0;
+
+    // Step every engine that runs without OpenGL this many times, then draw as many frames with the renderer in a
+    // hidden window, and fail if any heap allocation happens in the steady state, instead of starting the game.
+    int allocationCheckSteps = 0;
+};
+
+// Prints usage and exits on invalid arguments.
+Options ParseArguments(int argc, char** argv);
@@ -0,0 +1,157 @@
+#include "packedcompute.hpp"
+
+#include "shader.hpp"
+
+#include <GL/glew.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace {
+    const std::string packedShaderPath = "../packedcompute.glsl";
+
+    constexpr int cellsPerWord = 32;
+
+    // Binding points of the current and next generations' buffers, as declared in the shaders.
+    constexpr uint32_t currentBinding = 0;
+    constexpr uint32_t nextBinding = 1;
+}
+
+PackedComputeEngine::PackedComputeEngine(int m_width, int m_height, EdgeMode m_edgeMode)
+    : width(m_width)
+    , height(m_height)
+    , wordsPerRow((m_width + cellsPerWord - 1) / cellsPerWord)
+    , edgeMode(m_edgeMode)
+    , staging(static_cast<size_t>(wordsPerRow) * static_cast<size_t>(m_height))
+{
+    if (!ContextVersionAtLeast(4, 3)) {
+        std::cout << "Error: The packed engine needs OpenGL 4.3 for compute shaders, but the context is " << glGetString(GL_VERSION) << "\n";
+        exit(EXIT_FAILURE);
+    }
+
+    // Each buffer is a single storage block, whose size the driver limits.
+    const GLsizeiptr nBufferBytes = static_cast<GLsizeiptr>(staging.size() * sizeof(uint32_t));
+    GLint64 maxBlockBytes = 0;
+    glGetInteger64v(GL_MAX_SHADER_STORAGE_BLOCK_SIZE, &maxBlockBytes);
+    if (nBufferBytes > maxBlockBytes) {
+        std::cout << "Error: A " << width << "x" << height << " grid needs " << nBufferBytes / (1024 * 1024) << " MiB storage buffers, but this driver allows "
+                  << maxBlockBytes / (1024 * 1024) << " MiB. Use a smaller grid.\n";
+        exit(EXIT_FAILURE);
+    }
+
+    // Workgroup counts are limited to 65535 in each dimension, which only tall grids can reach.
+    GLint maxGroupsY = 0;
+    glGetIntegeri_v(GL_MAX_COMPUTE_WORK_GROUP_COUNT, 1, &maxGroupsY);
+    if ((height + workgroupRows - 1) / workgroupRows > maxGroupsY) {
+        std::cout << "Error: The packed engine can step grids of at most " << static_cast<int64_t>(maxGroupsY) * workgroupRows << " rows on this driver.\n";
+        exit(EXIT_FAILURE);
+    }
+
+    ShaderProgramSource source = ParseShader(packedShaderPath);
+    stepProgram = CreateComputeShader(source);
+    drawProgram = CreateShader(source);
+
+    // Core profiles can't draw without a vertex array, even though the full-screen triangle has no attributes.
+    glGenVertexArrays(1, &emptyVAO);
+
+    glGenBuffers(static_cast<GLsizei>(buffers.size()), buffers.data());
+    for (const uint32_t buffer : buffers) {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, nBufferBytes, nullptr, GL_DYNAMIC_COPY);
+    }
+}
+
+PackedComputeEngine::~PackedComputeEngine()
+{
+    glDeleteBuffers(static_cast<GLsizei>(buffers.size()), buffers.data());
+    glDeleteVertexArrays(1, &emptyVAO);
+    glDeleteProgram(stepProgram);
+    glDeleteProgram(drawProgram);
+}
+
+void PackedComputeEngine::Load(const CellGrid& grid)
+{
+    for (int y = 0; y < height; ++y) {
+        const uint8_t* row = Row(grid, y);
+        uint32_t* words = staging.data() + (static_cast<size_t>(y) * wordsPerRow);
+
+        for (int w = 0; w < wordsPerRow; ++w) {
+            const int nBits = std::min(cellsPerWord, width - (w * cellsPerWord));
+
+            uint32_t word = 0;
+            for (int bit = 0; bit < nBits; ++bit) {
+                word |= static_cast<uint32_t>(row[(w * cellsPerWord) + bit] != 0) << bit;
+            }
+            words[w] = word;
+        }
+    }
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffers[current]);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, static_cast<GLsizeiptr>(staging.size() * sizeof(uint32_t)), staging.data());
+}
+
+void PackedComputeEngine::Store(CellGrid& grid) const
+{
+    // Waits for the steps queued so far.
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffers[current]);
+    glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, static_cast<GLsizeiptr>(staging.size() * sizeof(uint32_t)), staging.data());
+
+    for (int y = 0; y < height; ++y) {
+        uint8_t* row = Row(grid, y);
+        const uint32_t* words = staging.data() + (static_cast<size_t>(y) * wordsPerRow);
+
+        for (int x = 0; x < width; ++x) {
+            row[x] = static_cast<uint8_t>((words[x / cellsPerWord] >> (x % cellsPerWord)) & 1);
+        }
+    }
+}
+
+void PackedComputeEngine::Step()
+{
+    glUseProgram(stepProgram);
+    glUniform2i(glGetUniformLocation(stepProgram, "u_GridSize"), width, height);
+    glUniform1i(glGetUniformLocation(stepProgram, "u_WordsPerRow"), wordsPerRow);
+    glUniform1i(glGetUniformLocation(stepProgram, "u_EdgeMode"), static_cast<int>(edgeMode));
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, currentBinding, buffers[current]);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, nextBinding, buffers[1 - current]);
+
+    const GLuint nGroupsX = static_cast<GLuint>((wordsPerRow + workgroupWords - 1) / workgroupWords);
+    const GLuint nGroupsY = static_cast<GLuint>((height + workgroupRows - 1) / workgroupRows);
+    glDispatchCompute(nGroupsX, nGroupsY, 1);
+
+    // The next step, and drawing, read what this one wrote.
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    current = 1 - current;
+    ++nSteps;
+}
+
+void PackedComputeEngine::WaitForSteps()
+{
+    glFinish();
+}
+
+void PackedComputeEngine::Draw(int viewportWidth, int viewportHeight)
+{
+    glUseProgram(drawProgram);
+    glUniform2i(glGetUniformLocation(drawProgram, "u_GridSize"), width, height);
+    glUniform1i(glGetUniformLocation(drawProgram, "u_WordsPerRow"), wordsPerRow);
+    glUniform2f(glGetUniformLocation(drawProgram, "u_ViewportSize"), static_cast<float>(viewportWidth), static_cast<float>(viewportHeight));
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, currentBinding, buffers[current]);
+
+    // A single triangle, positioned by the vertex shader, covers the viewport.
+    constexpr int nVertices = 3;
+    glBindVertexArray(emptyVAO);
+    glDrawArrays(GL_TRIANGLES, 0, nVertices);
+}
+
+void PackedComputeEngine::ReportStatistics(std::ostream& stream) const
+{
+    const size_t nBufferBytes = staging.size() * sizeof(uint32_t);
+
+    stream << "packed: " << nSteps << " generations in " << (wordsPerRow + workgroupWords - 1) / workgroupWords << "x"
+           << (height + workgroupRows - 1) / workgroupRows << " workgroups, two " << nBufferBytes / 1024 << " KiB storage buffers\n";
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "cellgrid.hpp"
+#include "gpuengine.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// ------------------
+// Bit-Packed Compute Shader Engine
+// ------------------
+
+// Steps the game in a compute shader over two shader storage buffers of 32 cells per uint, laid out like the bitboard
+// engine's rows: bit n of word w in a row holds the cell at x = (w * 32) + n. Each invocation computes one word with
+// full-adder logic, and each workgroup first loads its tile of words, plus a halo one word wide, into shared memory.
+// At a bit per cell, the largest storage block llvmpipe allows holds a grid of 2^30 cells.
+class PackedComputeEngine : public GpuEngine {
+public:
+    // Must match the local size in packedcompute.glsl. Each workgroup covers a tile of this many words by this many rows.
+    static constexpr int workgroupWords = 16;
+    static constexpr int workgroupRows = 16;
+
+    PackedComputeEngine(int width, int height, EdgeMode edgeMode);
+    ~PackedComputeEngine() override;
+
+    PackedComputeEngine(const PackedComputeEngine&) = delete;
+    PackedComputeEngine& operator=(const PackedComputeEngine&) = delete;
+
+    std::string_view Name() const override { return "packed"; }
+    void Load(const CellGrid& grid) override;
+    void Store(CellGrid& grid) const override;
+    void Step() override;
+    void WaitForSteps() override;
+    bool SupportsEdgeMode(EdgeMode) const override { return true; }
+    void ReportStatistics(std::ostream& stream) const override;
+    void Draw(int viewportWidth, int viewportHeight) override;
+
+private:
+    int width = 0;
+    int height = 0;
+    int wordsPerRow = 0;
+    EdgeMode edgeMode = EdgeMode::DEAD;
+
+    uint32_t stepProgram = 0;
+    uint32_t drawProgram = 0;
+    uint32_t emptyVAO = 0;
+
+    // buffers[current] holds the current generation.
+    std::array<uint32_t, 2> buffers = { 0, 0 };
+    int current = 0;
+
+    // Packed cells on their way to or from the GPU. Bits past the width of the grid are always 0.
+    mutable std::vector<uint32_t> staging;
+
+    uint64_t nSteps = 0;
+};
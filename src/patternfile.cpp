@@ -0,0 +1,92 @@
+#include "patternfile.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+Task WritePatternFile(FrameScheduler& scheduler, CellGrid grid, uint64_t generation, std::string path)
+{
+    std::ofstream file(path);
+    if (!file) {
+        std::cout << "Error: Couldn't open " << path << " to write the grid to\n";
+        co_return;
+    }
+
+    file << "!Name: Generation " << generation << "\n";
+
+    std::string line(static_cast<size_t>(grid.width) + 1, '\n');
+    for (int y = 0; y < grid.height; ++y) {
+        const uint8_t* row = Row(grid, y);
+        for (int x = 0; x < grid.width; ++x) {
+            line[x] = row[x] ? 'O' : '.';
+        }
+        file << line;
+
+        co_await scheduler.Yield();
+    }
+
+    if (!file.flush()) {
+        std::cout << "Error: Couldn't write the grid to " << path << "\n";
+        co_return;
+    }
+    std::cout << "Wrote generation " << generation << " to " << path << "\n";
+}
+
+Task LoadPatternFile(FrameScheduler& scheduler, SimulationThread& simulation, std::string path)
+{
+    std::ifstream file(path);
+    if (!file) {
+        std::cout << "Error: Couldn't open the pattern " << path << "\n";
+        co_return;
+    }
+
+    std::vector<std::string> rows;
+    size_t patternWidth = 0;
+    for (std::string line; std::getline(file, line);) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (!line.starts_with('!')) {
+            patternWidth = std::max(patternWidth, line.size());
+            rows.push_back(std::move(line));
+        }
+
+        co_await scheduler.Yield();
+    }
+
+    // The pattern is centred, and whatever doesn't fit in the grid is cut off. It's laid out a row at a time
+    // in a grid of its own, so that the restart only has to copy that over.
+    const CellGrid& current = simulation.LatestSnapshot().grid;
+    CellGrid pattern(current.width, current.height);
+    const int left = (pattern.width - static_cast<int>(patternWidth)) / 2;
+    const int top = (pattern.height - static_cast<int>(rows.size())) / 2;
+
+    for (int row = 0; row < static_cast<int>(rows.size()); ++row) {
+        const int y = top + row;
+        if (y < 0 || y >= pattern.height) {
+            continue;
+        }
+
+        for (int column = 0; column < static_cast<int>(rows[row].size()); ++column) {
+            const int x = left + column;
+            if (x >= 0 && x < pattern.width && rows[row][column] == 'O') {
+                SetCellState(pattern, x, y, State::ALIVE);
+            }
+        }
+
+        co_await scheduler.Yield();
+    }
+
+    auto fill = [&](CellGrid& grid) { std::copy(pattern.cells.begin(), pattern.cells.end(), grid.cells.begin()); };
+
+    // A restart that is still waiting to be picked up has to go first.
+    while (!simulation.RequestRestart(fill)) {
+        co_await scheduler.NextFrame();
+    }
+
+    if (left < 0 || top < 0) {
+        std::cout << "Warning: The " << patternWidth << "x" << rows.size() << " pattern in " << path << " was cut off to fit the grid\n";
+    }
+    std::cout << "Loaded " << path << "\n";
+}
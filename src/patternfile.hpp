@@ -0,0 +1,21 @@
+#pragma once
+
+#include "cellgrid.hpp"
+#include "framescheduler.hpp"
+#include "simulationthread.hpp"
+
+#include <cstdint>
+#include <string>
+
+// ------------------
+// Pattern Files
+// ------------------
+
+// Patterns are read and written in the plaintext format: lines starting with '!' are comments,
+// and every other line is a row of cells, 'O' for alive and '.' for dead.
+
+// Write grid to path a row at a time, as a frame task. The grid is a copy, so the simulation can carry on meanwhile.
+Task WritePatternFile(FrameScheduler& scheduler, CellGrid grid, uint64_t generation, std::string path);
+
+// Read the pattern at path a line at a time, as a frame task, then restart the game with it in the middle of the grid.
+Task LoadPatternFile(FrameScheduler& scheduler, SimulationThread& simulation, std::string path);
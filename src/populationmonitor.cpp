@@ -0,0 +1,54 @@
+#include "populationmonitor.hpp"
+
+#include <chrono>
+#include <iostream>
+
+PopulationMonitor::PopulationMonitor(GenerationStream& m_stream, uint64_t m_interval)
+    : stream(m_stream)
+    , interval(m_interval)
+    , thread(&PopulationMonitor::Run, this)
+{
+}
+
+PopulationMonitor::~PopulationMonitor()
+{
+    Stop();
+}
+
+void PopulationMonitor::Stop()
+{
+    stopping.store(true, std::memory_order_relaxed);
+
+    // The simulation may be blocked waiting for this consumer to make room.
+    stream.Close();
+
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+void PopulationMonitor::Run()
+{
+    uint64_t nextReport = 0;
+
+    while (!stopping.load(std::memory_order_relaxed)) {
+        const Snapshot* snapshot = stream.Front();
+        if (snapshot == nullptr) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+
+        // A restart sends the generation back to 0.
+        if (snapshot->generation < nextReport && nextReport - snapshot->generation > interval) {
+            nextReport = 0;
+        }
+
+        if (snapshot->generation >= nextReport) {
+            std::cout << "generation " << snapshot->generation << ": " << CountAliveCells(snapshot->grid) << " cells alive, ";
+            stream.ReportStatistics(std::cout);
+            nextReport = snapshot->generation + interval;
+        }
+
+        stream.Pop();
+    }
+}
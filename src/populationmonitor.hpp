@@ -0,0 +1,34 @@
+#pragma once
+
+#include "generationstream.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+// ------------------
+// Population Monitor
+// ------------------
+
+// Consumes a generation stream on its own thread and prints the population every interval generations,
+// along with what the stream had to do to keep up with the simulation.
+class PopulationMonitor {
+public:
+    // The stream must outlive the monitor.
+    PopulationMonitor(GenerationStream& stream, uint64_t interval);
+    ~PopulationMonitor();
+
+    PopulationMonitor(const PopulationMonitor&) = delete;
+    PopulationMonitor& operator=(const PopulationMonitor&) = delete;
+
+    void Stop();
+
+private:
+    GenerationStream& stream;
+    uint64_t interval = 0;
+
+    std::atomic<bool> stopping { false };
+    std::thread thread;
+
+    void Run();
+};
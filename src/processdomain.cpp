@@ -0,0 +1,383 @@
+#include "processdomain.hpp"
+
+#include "simdkernel.hpp"
+#include "threadpool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <string>
+#include <utility>
+
+#ifdef __linux__
+#include <climits>
+#include <csignal>
+#include <ctime>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+// Shared between the processes. Atomics on shared memory work across processes as long as they are lock-free,
+// and the futex calls need them to be plain 32 bit words.
+static_assert(std::atomic<uint32_t>::is_always_lock_free && sizeof(std::atomic<uint32_t>) == sizeof(uint32_t));
+
+struct ProcessDomainEngine::Control {
+    // Bumped by the coordinator for every command, which is what the workers wait on.
+    alignas(64) std::atomic<uint32_t> epoch { 0 };
+    std::atomic<uint32_t> command { 0 };
+
+    // Workers done with the current command. The coordinator waits for it to reach nProcesses.
+    alignas(64) std::atomic<uint32_t> nFinished { 0 };
+};
+
+struct alignas(64) ProcessDomainEngine::WorkerSlot {
+    // The epoch of the last generation whose edge rows the worker has published.
+    std::atomic<uint32_t> published { 0 };
+
+    // Written by the worker only, and read by the coordinator once all workers have finished.
+    uint64_t stepNanoseconds = 0;
+    uint64_t haloWaitNanoseconds = 0;
+};
+
+#ifdef __linux__
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    // How long the coordinator waits for the workers before checking whether one has died.
+    constexpr long workerCheckNanoseconds = 100'000'000;
+
+    uint64_t NanosecondsSince(Clock::time_point start)
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+    }
+
+    // Sleep while word still holds expected, or until the timeout. Not FUTEX_PRIVATE_FLAG, as the word is shared between processes.
+    void FutexWait(std::atomic<uint32_t>& word, uint32_t expected, const timespec* timeout = nullptr)
+    {
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, expected, timeout, nullptr, 0);
+    }
+
+    void FutexWakeAll(std::atomic<uint32_t>& word)
+    {
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+    }
+
+    size_t AlignUp(size_t bytes)
+    {
+        constexpr size_t cacheLine = 64;
+        return (bytes + cacheLine - 1) / cacheLine * cacheLine;
+    }
+
+    // Create a shared memory object of the given size. The name is only needed to create it, and the processes share
+    // the descriptor itself across fork(), so it is unlinked straight away and nothing is left behind in /dev/shm
+    // however the processes end. Returns -1, with errno set, on failure.
+    int CreateSharedMemory(const std::string& name, size_t bytes)
+    {
+        const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd == -1) {
+            return -1;
+        }
+        shm_unlink(name.c_str());
+
+        if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+            const int error = errno;
+            close(fd);
+            errno = error;
+            return -1;
+        }
+
+        return fd;
+    }
+
+    // Returns nullptr if the mapping fails. Empty objects get a placeholder, as mmap() can't map 0 bytes.
+    uint8_t* MapSharedMemory(int fd, size_t bytes)
+    {
+        void* address = mmap(nullptr, std::max<size_t>(bytes, 1), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        return address == MAP_FAILED ? nullptr : static_cast<uint8_t*>(address);
+    }
+}
+
+ProcessDomainEngine::ProcessDomainEngine(int m_width, int m_height, EdgeMode m_edgeMode, int m_nProcesses)
+    : width(m_width)
+    , height(m_height)
+    , edgeMode(m_edgeMode)
+    , nProcesses(std::clamp(m_nProcesses, 1, m_height))
+{
+    const size_t controlBytes = AlignUp(sizeof(Control));
+    const size_t slotBytes = AlignUp(sizeof(WorkerSlot) * nProcesses);
+    const size_t edgeBytes = AlignUp(static_cast<size_t>(2 * nProcesses) * (width + 2));
+    mappingBytes = controlBytes + slotBytes + edgeBytes;
+
+    // The control mapping is inherited by the workers across fork(). The bands are created now, so that running out
+    // of shared memory is found before any worker starts, but only mapped once the workers are running.
+    const std::string name = "/glautomata-" + std::to_string(getpid());
+    const int fd = CreateSharedMemory(name, mappingBytes);
+    mapping = fd == -1 ? nullptr : MapSharedMemory(fd, mappingBytes);
+    if (mapping == nullptr) {
+        std::cout << "Error: Couldn't create the shared memory " << name << ": " << std::strerror(errno) << "\n";
+        exit(EXIT_FAILURE);
+    }
+    close(fd);
+
+    std::vector<int> bandFds;
+    for (int worker = 0; worker < nProcesses; ++worker) {
+        const std::string bandName = name + "-band-" + std::to_string(worker);
+        const int bandFd = CreateSharedMemory(bandName, BandBytes(worker));
+        if (bandFd == -1) {
+            std::cout << "Error: Couldn't create the shared memory for worker " << worker << "'s band, " << BandBytes(worker) / (1024 * 1024)
+                      << " MiB: " << std::strerror(errno) << "\n";
+            exit(EXIT_FAILURE);
+        }
+        bandFds.push_back(bandFd);
+    }
+
+    uint8_t* bytes = static_cast<uint8_t*>(mapping);
+    control = new (bytes) Control;
+    slots = static_cast<WorkerSlot*>(static_cast<void*>(bytes + controlBytes));
+    for (int worker = 0; worker < nProcesses; ++worker) {
+        new (&slots[worker]) WorkerSlot;
+    }
+    edges = bytes + controlBytes + slotBytes;
+
+    // Output buffered now would otherwise be written once by every process.
+    std::cout.flush();
+
+    const int coordinatorId = getpid();
+    for (int worker = 0; worker < nProcesses; ++worker) {
+        const pid_t id = fork();
+        if (id == -1) {
+            std::cout << "Error: Couldn't start worker process " << worker << ": " << std::strerror(errno) << "\n";
+            StopAfterWorkerFailure(worker);
+        }
+        if (id == 0) {
+            WorkerMain(worker, coordinatorId, bandFds);
+        }
+        workerIds.push_back(id);
+    }
+
+    // This process gathers the bands for Load() and Store(), so it is the only one to map all of them.
+    for (int worker = 0; worker < nProcesses; ++worker) {
+        uint8_t* bandView = MapSharedMemory(bandFds[worker], BandBytes(worker));
+        if (bandView == nullptr) {
+            std::cout << "Error: Couldn't map worker " << worker << "'s band: " << std::strerror(errno) << "\n";
+            StopAfterWorkerFailure(worker);
+        }
+        bandViews.push_back(bandView);
+        close(bandFds[worker]);
+    }
+}
+
+ProcessDomainEngine::~ProcessDomainEngine()
+{
+    RunCommand(Command::EXIT);
+    for (const int id : workerIds) {
+        waitpid(id, nullptr, 0);
+    }
+
+    for (int worker = 0; worker < static_cast<int>(bandViews.size()); ++worker) {
+        munmap(bandViews[worker], std::max<size_t>(BandBytes(worker), 1));
+    }
+    munmap(mapping, mappingBytes);
+}
+
+void ProcessDomainEngine::RunCommand(Command command) const
+{
+    control->nFinished.store(0, std::memory_order_relaxed);
+    control->command.store(static_cast<uint32_t>(command), std::memory_order_relaxed);
+    control->epoch.fetch_add(1, std::memory_order_release);
+    FutexWakeAll(control->epoch);
+
+    if (command == Command::EXIT) {
+        return;
+    }
+
+    const timespec checkInterval = { 0, workerCheckNanoseconds };
+    uint32_t nFinished = 0;
+    while ((nFinished = control->nFinished.load(std::memory_order_acquire)) != static_cast<uint32_t>(nProcesses)) {
+        FutexWait(control->nFinished, nFinished, &checkInterval);
+
+        // A worker that died would leave the others waiting for its edge rows forever. A wait interrupted by a signal
+        // says nothing about the worker.
+        for (int worker = 0; worker < nProcesses; ++worker) {
+            const pid_t result = waitpid(workerIds[worker], nullptr, WNOHANG);
+            if (result > 0 || (result == -1 && errno != EINTR)) {
+                StopAfterWorkerFailure(worker);
+            }
+        }
+    }
+}
+
+void ProcessDomainEngine::StopAfterWorkerFailure(int worker) const
+{
+    std::cout << "Error: Worker process " << worker << " of the processes engine stopped, exiting\n";
+
+    for (const int id : workerIds) {
+        kill(id, SIGKILL);
+    }
+    exit(EXIT_FAILURE);
+}
+
+void ProcessDomainEngine::WorkerMain(int worker, int coordinatorId, const std::vector<int>& bandFds)
+{
+    // Workers go when the coordinator does, however it ends. It may already have gone before this was set up.
+    prctl(PR_SET_PDEATHSIG, SIGKILL);
+    if (getppid() != coordinatorId) {
+        _exit(EXIT_FAILURE);
+    }
+
+    // Only this worker's band is allocated, and mapped, in this process.
+    uint8_t* bandView = MapSharedMemory(bandFds[worker], BandBytes(worker));
+    for (const int bandFd : bandFds) {
+        close(bandFd);
+    }
+    if (bandView == nullptr) {
+        _exit(EXIT_FAILURE);
+    }
+
+    const Band band = BandOf(height, worker, nProcesses);
+    CellGrid grid(width, band.end - band.begin);
+    CellGrid nextGrid(width, band.end - band.begin);
+
+    // Neighbouring bands, and whether the band is at the top or bottom of a grid that doesn't wrap around.
+    const bool wraps = edgeMode == EdgeMode::TOROIDAL;
+    const int above = (worker + nProcesses - 1) % nProcesses;
+    const int below = (worker + 1) % nProcesses;
+    const bool hasAbove = worker > 0 || wraps;
+    const bool hasBelow = worker < nProcesses - 1 || wraps;
+
+    WorkerSlot& slot = slots[worker];
+    uint32_t epoch = 0;
+
+    while (true) {
+        uint32_t next = 0;
+        while ((next = control->epoch.load(std::memory_order_acquire)) == epoch) {
+            FutexWait(control->epoch, epoch);
+        }
+        epoch = next;
+
+        switch (static_cast<Command>(control->command.load(std::memory_order_relaxed))) {
+        case Command::LOAD:
+            for (int y = 0; y < grid.height; ++y) {
+                std::memcpy(Row(grid, y), bandView + (static_cast<size_t>(y) * width), width);
+            }
+            break;
+        case Command::STORE:
+            for (int y = 0; y < grid.height; ++y) {
+                std::memcpy(bandView + (static_cast<size_t>(y) * width), Row(grid, y), width);
+            }
+            break;
+        case Command::STEP: {
+            // The band's own halo comes first, which gets the columns and the grid's outer edges right.
+            // The rows above and below are then replaced by the neighbours' edge rows, halo cells included.
+            RefreshHalo(grid, edgeMode);
+            std::memcpy(EdgeRow(worker, 0), Row(grid, 0) - 1, width + 2);
+            std::memcpy(EdgeRow(worker, 1), Row(grid, grid.height - 1) - 1, width + 2);
+            slot.published.store(epoch, std::memory_order_release);
+            FutexWakeAll(slot.published);
+
+            auto receiveEdge = [&](int neighbour, int edge, int haloRow) {
+                std::atomic<uint32_t>& published = slots[neighbour].published;
+                uint32_t seen = 0;
+                while ((seen = published.load(std::memory_order_acquire)) != epoch) {
+                    FutexWait(published, seen);
+                }
+                std::memcpy(Row(grid, haloRow) - 1, EdgeRow(neighbour, edge), width + 2);
+            };
+
+            const auto waitStart = Clock::now();
+            if (hasAbove) {
+                receiveEdge(above, 1, -1);
+            }
+            if (hasBelow) {
+                receiveEdge(below, 0, grid.height);
+            }
+            slot.haloWaitNanoseconds += NanosecondsSince(waitStart);
+
+            const auto stepStart = Clock::now();
+            StepRows(grid, nextGrid, 0, grid.height);
+            std::swap(grid, nextGrid);
+            slot.stepNanoseconds += NanosecondsSince(stepStart);
+            break;
+        }
+        case Command::EXIT:
+            _exit(EXIT_SUCCESS);
+        }
+
+        if (control->nFinished.fetch_add(1, std::memory_order_acq_rel) + 1 == static_cast<uint32_t>(nProcesses)) {
+            FutexWakeAll(control->nFinished);
+        }
+    }
+}
+
+#else
+
+ProcessDomainEngine::ProcessDomainEngine(int m_width, int m_height, EdgeMode m_edgeMode, int m_nProcesses)
+    : width(m_width)
+    , height(m_height)
+    , edgeMode(m_edgeMode)
+    , nProcesses(m_nProcesses)
+{
+    std::cout << "Error: The processes engine needs Linux shared memory and futexes\n";
+    exit(EXIT_FAILURE);
+}
+
+ProcessDomainEngine::~ProcessDomainEngine() = default;
+
+void ProcessDomainEngine::RunCommand(Command) const {}
+
+#endif
+
+size_t ProcessDomainEngine::BandBytes(int worker) const
+{
+    const Band band = BandOf(height, worker, nProcesses);
+    return static_cast<size_t>(band.end - band.begin) * static_cast<size_t>(width);
+}
+
+void ProcessDomainEngine::Load(const CellGrid& source)
+{
+    for (int worker = 0; worker < nProcesses; ++worker) {
+        const Band band = BandOf(height, worker, nProcesses);
+        for (int y = band.begin; y < band.end; ++y) {
+            std::memcpy(bandViews[worker] + (static_cast<size_t>(y - band.begin) * width), Row(source, y), width);
+        }
+    }
+    RunCommand(Command::LOAD);
+}
+
+void ProcessDomainEngine::Store(CellGrid& destination) const
+{
+    RunCommand(Command::STORE);
+    for (int worker = 0; worker < nProcesses; ++worker) {
+        const Band band = BandOf(height, worker, nProcesses);
+        for (int y = band.begin; y < band.end; ++y) {
+            std::memcpy(Row(destination, y), bandViews[worker] + (static_cast<size_t>(y - band.begin) * width), width);
+        }
+    }
+}
+
+void ProcessDomainEngine::Step()
+{
+    RunCommand(Command::STEP);
+    ++nSteps;
+}
+
+void ProcessDomainEngine::ReportStatistics(std::ostream& stream) const
+{
+    stream << "processes: " << nProcesses << " workers, " << nSteps << " generations, " << mappingBytes / 1024 << " KiB shared by all, "
+           << (static_cast<size_t>(width) * static_cast<size_t>(height)) / 1024 << " KiB in bands\n";
+    for (int worker = 0; worker < nProcesses; ++worker) {
+        const Band band = BandOf(height, worker, nProcesses);
+        stream << "  worker " << worker << " (rows " << band.begin << " to " << band.end - 1 << "): stepping "
+               << slots[worker].stepNanoseconds / 1e6 << " ms, waiting for halos " << slots[worker].haloWaitNanoseconds / 1e6 << " ms\n";
+    }
+}
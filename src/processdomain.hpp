@@ -0,0 +1,75 @@
+#pragma once
+
+#include "cellgrid.hpp"
+#include "engine.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// ------------------
+// Process Domains
+// ------------------
+
+// Splits the grid into one band of rows per worker process, so each process only holds its own band, and a crashed
+// worker can't corrupt the others. This process coordinates: it sends each command to the workers and waits for them.
+//
+// The processes share one small POSIX shared memory mapping, holding the control words and each band's top and bottom
+// rows. Each band also has a shared memory object of its own, which Load() and Store() go through: its worker maps
+// only that one, and this process maps them all to gather the grid. Every generation each worker publishes its edge
+// rows, waits for its neighbours' with a futex, and copies theirs into its halo before stepping. Linux only.
+class ProcessDomainEngine : public Engine {
+public:
+    ProcessDomainEngine(int width, int height, EdgeMode edgeMode, int nProcesses);
+    ~ProcessDomainEngine() override;
+
+    ProcessDomainEngine(const ProcessDomainEngine&) = delete;
+    ProcessDomainEngine& operator=(const ProcessDomainEngine&) = delete;
+
+    std::string_view Name() const override { return "processes"; }
+    void Load(const CellGrid& source) override;
+    void Store(CellGrid& destination) const override;
+    void Step() override;
+    bool SupportsEdgeMode(EdgeMode) const override { return true; }
+    void ReportStatistics(std::ostream& stream) const override;
+
+private:
+    enum class Command : uint32_t {
+        LOAD = 0, // Copy the worker's band in from its shared memory.
+        STEP = 1, // Exchange halos and step one generation.
+        STORE = 2, // Copy the worker's band out to its shared memory.
+        EXIT = 3
+    };
+
+    struct Control;
+    struct WorkerSlot;
+
+    int width = 0;
+    int height = 0;
+    EdgeMode edgeMode = EdgeMode::DEAD;
+    int nProcesses = 1;
+
+    // The mapping shared by all processes, and where each part of it starts.
+    void* mapping = nullptr;
+    size_t mappingBytes = 0;
+    Control* control = nullptr;
+    WorkerSlot* slots = nullptr;
+    uint8_t* edges = nullptr;
+
+    // This process's mappings of each worker's band, width bytes per row with no halo.
+    std::vector<uint8_t*> bandViews;
+
+    std::vector<int> workerIds;
+    uint64_t nSteps = 0;
+
+    // Top (0) or bottom (1) row of a worker's band, with the halo cell either side.
+    uint8_t* EdgeRow(int worker, int edge) const { return edges + (static_cast<size_t>((2 * worker) + edge) * (width + 2)); }
+
+    size_t BandBytes(int worker) const;
+
+    // Run command on every worker and wait for them all to finish it.
+    void RunCommand(Command command) const;
+
+    // bandFds holds every band's shared memory object, of which the worker maps its own and closes the rest.
+    [[noreturn]] void WorkerMain(int worker, int coordinatorId, const std::vector<int>& bandFds);
+    [[noreturn]] void StopAfterWorkerFailure(int worker) const;
+};
@@ -0,0 +1,132 @@
+#include "shader.hpp"
+
+#include <GL/glew.h>
+
+#include <array>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+ShaderProgramSource ParseShader(const std::string_view filepath)
+{
+    // For separating the stringstreams.
+    enum class ShaderType {
+        NONE = -1,
+        VERTEX = 0,
+        FRAGMENT = 1,
+        COMPUTE = 2
+    };
+
+    std::ifstream stream(filepath.data());
+    std::array<std::stringstream, 3> ss;
+
+    std::string line = "";
+    ShaderType type = ShaderType::NONE;
+
+    // Read lines from the file while separating the shader types into different stringstreams.
+    while (getline(stream, line)) {
+        if (line.find("#shader") != std::string::npos) {
+            if (line.find("vertex") != std::string::npos) {
+                type = ShaderType::VERTEX;
+            } else if (line.find("fragment") != std::string::npos) {
+                type = ShaderType::FRAGMENT;
+            } else if (line.find("compute") != std::string::npos) {
+                type = ShaderType::COMPUTE;
+            }
+        } else if (type != ShaderType::NONE) {
+            ss[static_cast<int>(type)] << line << "\n";
+        }
+    }
+
+    ShaderProgramSource shaders;
+    shaders.vertexSource = ss[0].str();
+    shaders.fragmentSource = ss[1].str();
+    shaders.computeSource = ss[2].str();
+
+    return shaders;
+}
+
+uint32_t CompileShader(uint32_t shaderType, const std::string_view shaderSource)
+{
+    uint32_t id = glCreateShader(shaderType);
+
+    const char* src = shaderSource.data();
+
+    constexpr int nShaderSources = 1;
+    glShaderSource(id, nShaderSources, &src, nullptr);
+    glCompileShader(id);
+
+    // Error handling.
+    int result = 0;
+    glGetShaderiv(id, GL_COMPILE_STATUS, &result);
+    if (result == GL_FALSE) {
+        int errorMessageLength = 0;
+        glGetShaderiv(id, GL_INFO_LOG_LENGTH, &errorMessageLength);
+        std::string message(errorMessageLength, '\0');
+        glGetShaderInfoLog(id, errorMessageLength, &errorMessageLength, message.data());
+
+        // Simple logging
+        const std::string_view stageName = shaderType == GL_VERTEX_SHADER ? "vertex" : shaderType == GL_FRAGMENT_SHADER ? "fragment" : "compute";
+        std::cout << "Failed to compile " << stageName << " shader!\n"
+                  << message << std::endl;
+
+        glDeleteShader(id);
+
+        // id set to 0 as shader was not compiled
+        id = 0;
+    }
+
+    return id;
+}
+
+uint32_t CreateShader(ShaderProgramSource& source)
+{
+    const uint32_t program = glCreateProgram();
+    const uint32_t vs = CompileShader(GL_VERTEX_SHADER, source.vertexSource);
+    const uint32_t fs = CompileShader(GL_FRAGMENT_SHADER, source.fragmentSource);
+
+    // These steps create an executable that is run on the programmable vertex/fragment shader processer on the GPU.
+    glAttachShader(program, vs);
+    glAttachShader(program, fs);
+    glLinkProgram(program);
+    glValidateProgram(program);
+
+    // Delete to shaders once they have been linked and compiled.
+    glDeleteShader(vs);
+    glDeleteShader(fs);
+
+    return program;
+}
+
+uint32_t CreateComputeShader(ShaderProgramSource& source)
+{
+    const uint32_t program = glCreateProgram();
+    const uint32_t cs = CompileShader(GL_COMPUTE_SHADER, source.computeSource);
+    if (cs == 0) {
+        exit(EXIT_FAILURE);
+    }
+
+    glAttachShader(program, cs);
+    glLinkProgram(program);
+    glDeleteShader(cs);
+
+    int linked = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (linked == GL_FALSE) {
+        std::cout << "Error: Failed to link the compute shader\n";
+        exit(EXIT_FAILURE);
+    }
+
+    return program;
+}
+
+bool ContextVersionAtLeast(int major, int minor)
+{
+    int contextMajor = 0;
+    int contextMinor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &contextMajor);
+    glGetIntegerv(GL_MINOR_VERSION, &contextMinor);
+
+    return contextMajor > major || (contextMajor == major && contextMinor >= minor);
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// ----------------
+// Shader Functions
+// ----------------
+
+// The stages of a shader file. Each stage follows a "#shader vertex", "#shader fragment" or "#shader compute" line.
+struct ShaderProgramSource {
+    std::string vertexSource;
+    std::string fragmentSource;
+    std::string computeSource;
+};
+
+ShaderProgramSource ParseShader(const std::string_view filepath);
+
+// Returns 0 if the shader doesn't compile.
+uint32_t CompileShader(uint32_t shaderType, const std::string_view shaderSource);
+
+// Link the vertex and fragment stages of source into a program.
+uint32_t CreateShader(ShaderProgramSource& source);
+
+// Link the compute stage of source into a program. Exits if it doesn't compile or link,
+// since the engines that use compute shaders can't run without them.
+uint32_t CreateComputeShader(ShaderProgramSource& source);
+
+// Whether the current context's OpenGL version is at least major.minor.
+bool ContextVersionAtLeast(int major, int minor);
@@ -0,0 +1,235 @@
+#include "simdkernel.hpp"
+
+#include <algorithm>
+#include <array>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define GLAUTOMATA_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace {
+    // Steps columns [xBegin, xEnd) of a row. above, middle and below point at x = 0 of the rows either side of, and at, the output row.
+    // Columns xBegin - 1 and xEnd are read too, which the grid's halo guarantees exist. Each kernel sums the three rows with vector adds, then the sums of three neighbouring columns.
+    // That total includes the cell itself, so a cell is born on 3, and survives on 3 or 4.
+    using RowKernel = void (*)(const uint8_t* above, const uint8_t* middle, const uint8_t* below, uint8_t* next, int xBegin, int xEnd);
+
+    inline uint8_t ApplyRule(uint8_t cell, int total)
+    {
+        return static_cast<uint8_t>(total == 3 || (cell && total == 4));
+    }
+
+    void StepRowScalar(const uint8_t* above, const uint8_t* middle, const uint8_t* below, uint8_t* next, int xBegin, int xEnd)
+    {
+        for (int x = xBegin; x < xEnd; ++x) {
+            int total = 0;
+            for (int column = x - 1; column <= x + 1; ++column) {
+                total += above[column] + middle[column] + below[column];
+            }
+            next[x] = ApplyRule(middle[x], total);
+        }
+    }
+
+#ifdef GLAUTOMATA_X86_KERNELS
+
+    // The last vector is moved back to end with the range, overlapping the one before it, which is harmless
+    // since each output only depends on current. Ranges narrower than a vector go through the next narrower instruction set.
+
+    // Sum of the three rows at columns [x, x + vectorWidth).
+    __attribute__((target("sse2"))) inline __m128i ColumnSumSSE2(const uint8_t* above, const uint8_t* middle, const uint8_t* below, int x)
+    {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(above + x));
+        const __m128i m = _mm_loadu_si128(reinterpret_cast<const __m128i*>(middle + x));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(below + x));
+        return _mm_add_epi8(_mm_add_epi8(a, m), b);
+    }
+
+    __attribute__((target("avx2"))) inline __m256i ColumnSumAVX2(const uint8_t* above, const uint8_t* middle, const uint8_t* below, int x)
+    {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(above + x));
+        const __m256i m = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(middle + x));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(below + x));
+        return _mm256_add_epi8(_mm256_add_epi8(a, m), b);
+    }
+
+    __attribute__((target("avx512f,avx512bw"))) inline __m512i ColumnSumAVX512(const uint8_t* above, const uint8_t* middle, const uint8_t* below, int x)
+    {
+        const __m512i a = _mm512_loadu_si512(above + x);
+        const __m512i m = _mm512_loadu_si512(middle + x);
+        const __m512i b = _mm512_loadu_si512(below + x);
+        return _mm512_add_epi8(_mm512_add_epi8(a, m), b);
+    }
+
+    __attribute__((target("sse2"))) void StepRowSSE2(const uint8_t* above, const uint8_t* middle, const uint8_t* below, uint8_t* next, int xBegin, int xEnd)
+    {
+        constexpr int vectorWidth = 16;
+
+        const __m128i three = _mm_set1_epi8(3);
+        const __m128i four = _mm_set1_epi8(4);
+        const __m128i one = _mm_set1_epi8(1);
+
+        if (xEnd - xBegin < vectorWidth) {
+            StepRowScalar(above, middle, below, next, xBegin, xEnd);
+            return;
+        }
+
+        for (int x = xBegin; x < xEnd; x += vectorWidth) {
+            x = std::min(x, xEnd - vectorWidth);
+
+            const __m128i total = _mm_add_epi8(_mm_add_epi8(ColumnSumSSE2(above, middle, below, x - 1), ColumnSumSSE2(above, middle, below, x)), ColumnSumSSE2(above, middle, below, x + 1));
+            const __m128i alive = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(middle + x)), one);
+
+            // SSE2 has no byte blend, so select with and/or instead.
+            const __m128i born = _mm_cmpeq_epi8(total, three);
+            const __m128i survives = _mm_and_si128(alive, _mm_cmpeq_epi8(total, four));
+            const __m128i result = _mm_and_si128(_mm_or_si128(born, survives), one);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(next + x), result);
+        }
+    }
+
+    __attribute__((target("avx2"))) void StepRowAVX2(const uint8_t* above, const uint8_t* middle, const uint8_t* below, uint8_t* next, int xBegin, int xEnd)
+    {
+        constexpr int vectorWidth = 32;
+
+        const __m256i three = _mm256_set1_epi8(3);
+        const __m256i four = _mm256_set1_epi8(4);
+        const __m256i one = _mm256_set1_epi8(1);
+
+        if (xEnd - xBegin < vectorWidth) {
+            StepRowSSE2(above, middle, below, next, xBegin, xEnd);
+            return;
+        }
+
+        for (int x = xBegin; x < xEnd; x += vectorWidth) {
+            x = std::min(x, xEnd - vectorWidth);
+
+            const __m256i total = _mm256_add_epi8(_mm256_add_epi8(ColumnSumAVX2(above, middle, below, x - 1), ColumnSumAVX2(above, middle, below, x)), ColumnSumAVX2(above, middle, below, x + 1));
+            const __m256i alive = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(middle + x)), one);
+
+            // Live cells keep living on 3 or 4, dead cells only come alive on 3.
+            const __m256i born = _mm256_cmpeq_epi8(total, three);
+            const __m256i survives = _mm256_or_si256(born, _mm256_cmpeq_epi8(total, four));
+            const __m256i result = _mm256_and_si256(_mm256_blendv_epi8(born, survives, alive), one);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(next + x), result);
+        }
+    }
+
+    __attribute__((target("avx512f,avx512bw"))) void StepRowAVX512(const uint8_t* above, const uint8_t* middle, const uint8_t* below, uint8_t* next, int xBegin, int xEnd)
+    {
+        constexpr int vectorWidth = 64;
+
+        const __m512i three = _mm512_set1_epi8(3);
+        const __m512i four = _mm512_set1_epi8(4);
+        const __m512i one = _mm512_set1_epi8(1);
+
+        if (xEnd - xBegin < vectorWidth) {
+            StepRowAVX2(above, middle, below, next, xBegin, xEnd);
+            return;
+        }
+
+        for (int x = xBegin; x < xEnd; x += vectorWidth) {
+            x = std::min(x, xEnd - vectorWidth);
+
+            const __m512i total = _mm512_add_epi8(_mm512_add_epi8(ColumnSumAVX512(above, middle, below, x - 1), ColumnSumAVX512(above, middle, below, x)), ColumnSumAVX512(above, middle, below, x + 1));
+            const __mmask64 alive = _mm512_cmpeq_epi8_mask(_mm512_loadu_si512(middle + x), one);
+
+            // Compares produce mask registers, which blend the 1s straight into a zeroed vector.
+            const __mmask64 born = _mm512_cmpeq_epi8_mask(total, three);
+            const __mmask64 survives = alive & _mm512_cmpeq_epi8_mask(total, four);
+            _mm512_storeu_si512(next + x, _mm512_maskz_mov_epi8(born | survives, one));
+        }
+    }
+
+#endif
+
+    InstructionSet DetectInstructionSet()
+    {
+#ifdef GLAUTOMATA_X86_KERNELS
+        __builtin_cpu_init();
+
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+            return InstructionSet::AVX512;
+        } else if (__builtin_cpu_supports("avx2")) {
+            return InstructionSet::AVX2;
+        } else if (__builtin_cpu_supports("sse2")) {
+            return InstructionSet::SSE2;
+        }
+#endif
+        return InstructionSet::SCALAR;
+    }
+
+    RowKernel KernelFor(InstructionSet instructionSet)
+    {
+        switch (instructionSet) {
+#ifdef GLAUTOMATA_X86_KERNELS
+        case InstructionSet::AVX512:
+            return StepRowAVX512;
+        case InstructionSet::AVX2:
+            return StepRowAVX2;
+        case InstructionSet::SSE2:
+            return StepRowSSE2;
+#endif
+        default:
+            return StepRowScalar;
+        }
+    }
+
+    // Chosen once at startup.
+    const InstructionSet supportedInstructionSet = DetectInstructionSet();
+    InstructionSet selectedInstructionSet = supportedInstructionSet;
+    RowKernel selectedKernel = KernelFor(supportedInstructionSet);
+
+    constexpr std::array<std::string_view, 4> instructionSetNames = { "scalar", "sse2", "avx2", "avx512" };
+}
+
+InstructionSet SupportedInstructionSet()
+{
+    return supportedInstructionSet;
+}
+
+bool SelectInstructionSet(InstructionSet instructionSet)
+{
+    if (instructionSet > supportedInstructionSet) {
+        return false;
+    }
+
+    selectedInstructionSet = instructionSet;
+    selectedKernel = KernelFor(instructionSet);
+
+    return true;
+}
+
+InstructionSet SelectedInstructionSet()
+{
+    return selectedInstructionSet;
+}
+
+std::string_view InstructionSetName(InstructionSet instructionSet)
+{
+    return instructionSetNames[static_cast<int>(instructionSet)];
+}
+
+bool ParseInstructionSet(std::string_view name, InstructionSet& instructionSet)
+{
+    for (size_t index = 0; index < instructionSetNames.size(); ++index) {
+        if (name == instructionSetNames[index]) {
+            instructionSet = static_cast<InstructionSet>(index);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void StepRows(const CellGrid& current, CellGrid& next, int rowBegin, int rowEnd)
+{
+    StepBlock(current, next, 0, current.width, rowBegin, rowEnd);
+}
+
+void StepBlock(const CellGrid& current, CellGrid& next, int xBegin, int xEnd, int rowBegin, int rowEnd)
+{
+    // Rows -1 and height are the halo, so every row has neighbours above and below it.
+    for (int y = rowBegin; y < rowEnd; ++y) {
+        selectedKernel(Row(current, y - 1), Row(current, y), Row(current, y + 1), Row(next, y), xBegin, xEnd);
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "cellgrid.hpp"
+
+#include <string_view>
+
+// ------------------
+// SIMD Neighbour-Sum Kernel
+// ------------------
+
+// Vector instruction sets the byte-per-cell kernel can be compiled for, from slowest to fastest.
+enum class InstructionSet {
+    SCALAR = 0,
+    SSE2 = 1,
+    AVX2 = 2,
+    AVX512 = 3
+};
+
+// Fastest instruction set the CPU supports, found through CPUID.
+InstructionSet SupportedInstructionSet();
+
+// The kernel picks the supported instruction set at startup. This overrides it, e.g. to compare against the scalar path.
+// Returns false, leaving the selection unchanged, if the CPU doesn't support instructionSet.
+bool SelectInstructionSet(InstructionSet instructionSet);
+InstructionSet SelectedInstructionSet();
+
+std::string_view InstructionSetName(InstructionSet instructionSet);
+
+// Returns false if name isn't the name of an instruction set.
+bool ParseInstructionSet(std::string_view name, InstructionSet& instructionSet);
+
+// Write rows [rowBegin, rowEnd) of the generation after current into next, using the selected instruction set.
+// Every instruction set gives identical results. Neighbours past the edges are read from current's halo,
+// which must have been refreshed since current last changed. next's halo is left as it was.
+void StepRows(const CellGrid& current, CellGrid& next, int rowBegin, int rowEnd);
+
+// As StepRows(), but only for the cells in columns [xBegin, xEnd) of those rows.
+void StepBlock(const CellGrid& current, CellGrid& next, int xBegin, int xEnd, int rowBegin, int rowEnd);
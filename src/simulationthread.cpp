@@ -0,0 +1,85 @@
+#include "simulationthread.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <utility>
+
+SimulationThread::SimulationThread(Engine& m_engine, const CellGrid& grid, int m_generationsPerSecond, int m_statisticsInterval,
+    std::vector<GenerationStream*> m_streams)
+    : engine(m_engine)
+    , snapshots(Snapshot { grid, 0 })
+    , streams(std::move(m_streams))
+    , restartGrid(grid.width, grid.height)
+    , generationsPerSecond(m_generationsPerSecond)
+    , statisticsInterval(m_statisticsInterval)
+    , thread(&SimulationThread::Run, this)
+{
+}
+
+SimulationThread::~SimulationThread()
+{
+    Stop();
+}
+
+void SimulationThread::Stop()
+{
+    stopping.store(true, std::memory_order_relaxed);
+
+    // A stream that blocks on its consumer would otherwise keep the thread from noticing.
+    for (GenerationStream* stream : streams) {
+        stream->Close();
+    }
+
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+void SimulationThread::Run()
+{
+    using Clock = std::chrono::steady_clock;
+
+    const Clock::duration period = generationsPerSecond == 0
+        ? Clock::duration::zero()
+        : std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / generationsPerSecond));
+    Clock::time_point deadline = Clock::now();
+
+    uint64_t generation = 0;
+    uint64_t nSteps = 0;
+
+    while (!stopping.load(std::memory_order_relaxed)) {
+        if (restartRequested.load(std::memory_order_acquire)) {
+            engine.Load(restartGrid);
+            generation = 0;
+            restartRequested.store(false, std::memory_order_release);
+        }
+
+        engine.Step();
+        generation += engine.GenerationsPerStep();
+
+        Snapshot& snapshot = snapshots.Back();
+        engine.Store(snapshot.grid);
+        snapshot.generation = generation;
+        snapshots.Publish();
+
+        // The render thread only reads the snapshot too, so it can go to the streams after it has been handed over,
+        // without a stream that blocks holding up the display.
+        for (GenerationStream* stream : streams) {
+            stream->Publish(snapshot);
+        }
+
+        if (statisticsInterval != 0 && ++nSteps % statisticsInterval == 0) {
+            engine.ReportStatistics(std::cout);
+        }
+
+        if (period != Clock::duration::zero()) {
+            // Steps that ran late aren't made up for with a burst of steps afterwards.
+            deadline += period;
+            const Clock::time_point now = Clock::now();
+            if (deadline < now) {
+                deadline = now;
+            }
+            std::this_thread::sleep_until(deadline);
+        }
+    }
+}
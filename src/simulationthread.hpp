@@ -0,0 +1,68 @@
+#pragma once
+
+#include "cellgrid.hpp"
+#include "engine.hpp"
+#include "generationstream.hpp"
+#include "triplebuffer.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// ------------------
+// Simulation Thread
+// ------------------
+
+// Steps an engine on its own thread, so the simulation rate doesn't depend on the display's, and a slow step doesn't hold up a frame.
+// Every generation is stored into a triple buffer, from which the render thread draws the newest complete one,
+// and published to each of the streams of other consumers.
+class SimulationThread {
+public:
+    // Advances the engine generationsPerSecond times a second, or as fast as it can if that is 0.
+    // Prints the engine's statistics every statisticsInterval steps if statisticsInterval isn't 0.
+    // grid must hold the engine's current cells. The streams must outlive the thread.
+    SimulationThread(Engine& engine, const CellGrid& grid, int generationsPerSecond, int statisticsInterval,
+        std::vector<GenerationStream*> streams = {});
+    ~SimulationThread();
+
+    SimulationThread(const SimulationThread&) = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+
+    // Render thread side: pick up the newest generation, if there is a new one. Returns whether LatestSnapshot() changed.
+    bool Update() { return snapshots.Update(); }
+    const Snapshot& LatestSnapshot() const { return snapshots.Front(); }
+
+    // Render thread side: unless a restart is already waiting to be picked up, call fill(grid) to write new cells into
+    // a grid the simulation thread will load the engine from before its next step. Returns false if a restart was waiting.
+    template <typename Fill>
+    bool RequestRestart(Fill&& fill)
+    {
+        if (restartRequested.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        fill(restartGrid);
+        restartRequested.store(true, std::memory_order_release);
+        return true;
+    }
+
+    // Close the streams, finish the current step and join the thread.
+    void Stop();
+
+private:
+    Engine& engine;
+    TripleBuffer<Snapshot> snapshots;
+    std::vector<GenerationStream*> streams;
+
+    CellGrid restartGrid;
+    std::atomic<bool> restartRequested { false };
+
+    int generationsPerSecond = 0;
+    int statisticsInterval = 0;
+
+    std::atomic<bool> stopping { false };
+    std::thread thread;
+
+    void Run();
+};
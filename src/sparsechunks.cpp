@@ -0,0 +1,240 @@
+#include "sparsechunks.hpp"
+
+#include "bitboard.hpp"
+
+#include <algorithm>
+#include <ostream>
+
+namespace {
+    // Division and remainder rounding towards negative infinity, so that cell -1 is in chunk -1.
+    inline int64_t FloorDivide(int64_t value, int64_t divisor)
+    {
+        return (value >= 0 ? value : value - divisor + 1) / divisor;
+    }
+
+    inline int FloorModulo(int64_t value, int64_t divisor)
+    {
+        return static_cast<int>(value - (FloorDivide(value, divisor) * divisor));
+    }
+
+    constexpr int chunkBits = 64;
+    constexpr uint64_t westColumn = uint64_t(1);
+    constexpr uint64_t eastColumn = uint64_t(1) << (chunkBits - 1);
+}
+
+SparseChunkEngine::SparseChunkEngine(int m_width, int m_height)
+    : width(m_width)
+    , height(m_height)
+{
+    static_assert(chunkSize == chunkBits, "Each row of a chunk is a single word.");
+
+    Clear();
+}
+
+void SparseChunkEngine::Clear()
+{
+    chunks.clear();
+    freeChunks.clear();
+    liveChunks.clear();
+    chunkMap.clear();
+    current = 0;
+
+    chunks.emplace_back();
+}
+
+SparseChunkEngine::ChunkId SparseChunkEngine::Find(int64_t x, int64_t y) const
+{
+    const auto chunk = chunkMap.find(Key(x, y));
+    return chunk == chunkMap.end() ? emptyChunk : chunk->second;
+}
+
+SparseChunkEngine::ChunkId SparseChunkEngine::FindOrCreate(int64_t x, int64_t y)
+{
+    const auto [entry, inserted] = chunkMap.try_emplace(Key(x, y), emptyChunk);
+    if (!inserted) {
+        return entry->second;
+    }
+
+    ChunkId id = emptyChunk;
+    if (!freeChunks.empty()) {
+        id = freeChunks.back();
+        freeChunks.pop_back();
+        chunks[id] = Chunk();
+    } else {
+        chunks.emplace_back();
+        id = static_cast<ChunkId>(chunks.size() - 1);
+    }
+
+    chunks[id].x = x;
+    chunks[id].y = y;
+    entry->second = id;
+    liveChunks.push_back(id);
+    ++nChunksAllocated;
+
+    return id;
+}
+
+void SparseChunkEngine::Free(ChunkId id)
+{
+    chunkMap.erase(Key(chunks[id].x, chunks[id].y));
+    freeChunks.push_back(id);
+    ++nChunksFreed;
+}
+
+void SparseChunkEngine::Load(const CellGrid& grid)
+{
+    Clear();
+
+    for (int y = 0; y < grid.height; ++y) {
+        for (int x = 0; x < grid.width; ++x) {
+            if (GetCellState(grid, x, y) == State::ALIVE) {
+                Chunk& chunk = chunks[FindOrCreate(FloorDivide(x, chunkSize), FloorDivide(y, chunkSize))];
+                chunk.rows[current][FloorModulo(y, chunkSize)] |= uint64_t(1) << FloorModulo(x, chunkSize);
+            }
+        }
+    }
+}
+
+void SparseChunkEngine::Store(CellGrid& grid) const
+{
+    std::fill(grid.cells.begin(), grid.cells.end(), 0);
+
+    // Only the chunks that exist are visited, whatever the size of the view.
+    for (const ChunkId id : liveChunks) {
+        const Chunk& chunk = chunks[id];
+        const int64_t chunkX = chunk.x * chunkSize;
+        const int64_t chunkY = chunk.y * chunkSize;
+
+        if (chunkX >= grid.width || chunkY >= grid.height || chunkX + chunkSize <= 0 || chunkY + chunkSize <= 0) {
+            continue;
+        }
+
+        for (int row = 0; row < chunkSize; ++row) {
+            const uint64_t word = chunk.rows[current][row];
+            for (int column = 0; column < chunkSize && word != 0; ++column) {
+                if ((word >> column) & 1) {
+                    SetCellState(grid, static_cast<int>(chunkX + column), static_cast<int>(chunkY + row), State::ALIVE);
+                }
+            }
+        }
+    }
+}
+
+void SparseChunkEngine::CreateNeighboursForEdges(ChunkId id)
+{
+    // Copied, as creating chunks may reallocate the chunk storage.
+    const int64_t x = chunks[id].x;
+    const int64_t y = chunks[id].y;
+    const std::array<uint64_t, chunkSize> rows = chunks[id].rows[current];
+
+    uint64_t columns = 0;
+    for (const uint64_t row : rows) {
+        columns |= row;
+    }
+
+    // Cells can only be born next to live cells, so a neighbour is only needed where an edge has live cells.
+    const bool north = rows[0] != 0;
+    const bool south = rows[chunkSize - 1] != 0;
+    const bool west = (columns & westColumn) != 0;
+    const bool east = (columns & eastColumn) != 0;
+
+    if (north) {
+        FindOrCreate(x, y - 1);
+    }
+    if (south) {
+        FindOrCreate(x, y + 1);
+    }
+    if (west) {
+        FindOrCreate(x - 1, y);
+    }
+    if (east) {
+        FindOrCreate(x + 1, y);
+    }
+    if ((rows[0] & westColumn) != 0) {
+        FindOrCreate(x - 1, y - 1);
+    }
+    if ((rows[0] & eastColumn) != 0) {
+        FindOrCreate(x + 1, y - 1);
+    }
+    if ((rows[chunkSize - 1] & westColumn) != 0) {
+        FindOrCreate(x - 1, y + 1);
+    }
+    if ((rows[chunkSize - 1] & eastColumn) != 0) {
+        FindOrCreate(x + 1, y + 1);
+    }
+}
+
+void SparseChunkEngine::Step()
+{
+    // Make room for growth. Chunks created here start empty, so don't need neighbours of their own.
+    const size_t nChunksBeforeGrowth = liveChunks.size();
+    for (size_t index = 0; index < nChunksBeforeGrowth; ++index) {
+        CreateNeighboursForEdges(liveChunks[index]);
+    }
+
+    for (const ChunkId id : liveChunks) {
+        Chunk& chunk = chunks[id];
+        chunk.neighbours[NORTH_WEST] = Find(chunk.x - 1, chunk.y - 1);
+        chunk.neighbours[NORTH] = Find(chunk.x, chunk.y - 1);
+        chunk.neighbours[NORTH_EAST] = Find(chunk.x + 1, chunk.y - 1);
+        chunk.neighbours[WEST] = Find(chunk.x - 1, chunk.y);
+        chunk.neighbours[EAST] = Find(chunk.x + 1, chunk.y);
+        chunk.neighbours[SOUTH_WEST] = Find(chunk.x - 1, chunk.y + 1);
+        chunk.neighbours[SOUTH] = Find(chunk.x, chunk.y + 1);
+        chunk.neighbours[SOUTH_EAST] = Find(chunk.x + 1, chunk.y + 1);
+    }
+
+    const int next = 1 - current;
+
+    for (const ChunkId id : liveChunks) {
+        Chunk& chunk = chunks[id];
+        auto rowsOf = [&](Direction direction) -> const std::array<uint64_t, chunkSize>& {
+            return chunks[chunk.neighbours[direction]].rows[current];
+        };
+
+        const auto& rows = chunk.rows[current];
+        const auto& westRows = rowsOf(WEST);
+        const auto& eastRows = rowsOf(EAST);
+
+        for (int row = 0; row < chunkSize; ++row) {
+            // Rows past the top and bottom of the chunk come from the chunks to the north and south.
+            const bool top = row == 0;
+            const bool bottom = row == chunkSize - 1;
+
+            const uint64_t abovePrevious = top ? rowsOf(NORTH_WEST)[chunkSize - 1] : westRows[row - 1];
+            const uint64_t above = top ? rowsOf(NORTH)[chunkSize - 1] : rows[row - 1];
+            const uint64_t aboveNext = top ? rowsOf(NORTH_EAST)[chunkSize - 1] : eastRows[row - 1];
+            const uint64_t belowPrevious = bottom ? rowsOf(SOUTH_WEST)[0] : westRows[row + 1];
+            const uint64_t below = bottom ? rowsOf(SOUTH)[0] : rows[row + 1];
+            const uint64_t belowNext = bottom ? rowsOf(SOUTH_EAST)[0] : eastRows[row + 1];
+
+            chunk.rows[next][row] = StepBitWord(abovePrevious, above, aboveNext,
+                westRows[row], rows[row], eastRows[row],
+                belowPrevious, below, belowNext);
+        }
+    }
+
+    current = next;
+
+    // Free the chunks that died out. Any that are still needed will be recreated next step.
+    for (size_t index = 0; index < liveChunks.size();) {
+        const auto& rows = chunks[liveChunks[index]].rows[current];
+        const bool empty = std::all_of(rows.begin(), rows.end(), [](uint64_t row) { return row == 0; });
+
+        if (empty) {
+            Free(liveChunks[index]);
+            liveChunks[index] = liveChunks.back();
+            liveChunks.pop_back();
+        } else {
+            ++index;
+        }
+    }
+}
+
+void SparseChunkEngine::ReportStatistics(std::ostream& stream) const
+{
+    const size_t chunkBytes = sizeof(Chunk) * liveChunks.size();
+
+    stream << "sparse: " << liveChunks.size() << " chunks (" << chunkBytes / 1024 << " KiB) in use, "
+           << nChunksAllocated << " allocated and " << nChunksFreed << " freed so far\n";
+}
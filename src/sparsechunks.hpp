@@ -0,0 +1,83 @@
+#pragma once
+
+#include "cellgrid.hpp"
+#include "engine.hpp"
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// ------------------
+// Sparse Chunk Map
+// ------------------
+
+// Unbounded plane stored as a hash map of 64x64 cell chunks, each stepped with the bitboard's full-adder logic.
+// Chunks are allocated when activity reaches them and freed once they are empty, so memory follows the live area
+// rather than its bounding box. The CellGrid passed to Load() and Store() is a view of the plane with its corner at (0, 0).
+class SparseChunkEngine : public Engine {
+public:
+    static constexpr int chunkSize = 64;
+
+    SparseChunkEngine(int width, int height);
+
+    std::string_view Name() const override { return "sparse"; }
+    void Load(const CellGrid& grid) override;
+    void Store(CellGrid& grid) const override;
+    void Step() override;
+    bool AllocatesInStep() const override { return true; }
+    void ReportStatistics(std::ostream& stream) const override;
+
+    size_t ChunkCount() const { return liveChunks.size(); }
+
+private:
+    using ChunkId = uint32_t;
+
+    // Neighbouring chunks, in the order used by Chunk::neighbours.
+    enum Direction {
+        NORTH_WEST,
+        NORTH,
+        NORTH_EAST,
+        WEST,
+        EAST,
+        SOUTH_WEST,
+        SOUTH,
+        SOUTH_EAST,
+        N_DIRECTIONS
+    };
+
+    struct Chunk {
+        // Two generations of rows, with the cell at x in bit x of its row; `current` picks the live one.
+        std::array<std::array<uint64_t, chunkSize>, 2> rows {};
+
+        // Chunk coordinates, which are cell coordinates divided by chunkSize.
+        int64_t x = 0;
+        int64_t y = 0;
+
+        // Filled in at the start of each step. Missing neighbours point at the empty chunk.
+        std::array<ChunkId, N_DIRECTIONS> neighbours {};
+    };
+
+    // Chunk 0 is always empty and stands in for every chunk that doesn't exist.
+    static constexpr ChunkId emptyChunk = 0;
+
+    int width = 0;
+    int height = 0;
+    int current = 0;
+
+    std::vector<Chunk> chunks;
+    std::vector<ChunkId> freeChunks;
+    std::vector<ChunkId> liveChunks;
+    std::unordered_map<uint64_t, ChunkId> chunkMap;
+
+    uint64_t nChunksAllocated = 0;
+    uint64_t nChunksFreed = 0;
+
+    static uint64_t Key(int64_t x, int64_t y) { return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y); }
+
+    ChunkId Find(int64_t x, int64_t y) const;
+    ChunkId FindOrCreate(int64_t x, int64_t y);
+    void Free(ChunkId id);
+    void Clear();
+    void CreateNeighboursForEdges(ChunkId id);
+};
@@ -0,0 +1,115 @@
+#include "temporalblocking.hpp"
+
+#include "numa.hpp"
+#include "simdkernel.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <ostream>
+#include <utility>
+
+TemporalBlockingEngine::TemporalBlockingEngine(int width, int height, int m_depth, int nThreads, bool pinThreads)
+    : grid(width, height, Allocation::UNTOUCHED)
+    , nextGrid(width, height, Allocation::UNTOUCHED)
+    , depth(m_depth)
+    , nTilesX((width + tileWidth - 1) / tileWidth)
+    , nTilesY((height + tileHeight - 1) / tileHeight)
+    , pool(nThreads, pinThreads)
+    , scheduler(pool)
+{
+    // Workers start on equal runs of tiles in row-major order, which roughly match the bands they first touch.
+    FirstTouchBands(pool, grid);
+    FirstTouchBands(pool, nextGrid);
+
+    const int scratchWidth = tileWidth + (2 * depth);
+    const int scratchHeight = tileHeight + (2 * depth);
+
+    scratches.reserve(pool.ThreadCount());
+    for (int thread = 0; thread < pool.ThreadCount(); ++thread) {
+        scratches.push_back({ CellGrid(scratchWidth, scratchHeight), CellGrid(scratchWidth, scratchHeight) });
+    }
+}
+
+void TemporalBlockingEngine::Load(const CellGrid& source)
+{
+    CopyBands(pool, source, grid);
+}
+
+void TemporalBlockingEngine::Store(CellGrid& destination) const
+{
+    std::copy(grid.cells.begin(), grid.cells.end(), destination.cells.begin());
+}
+
+void TemporalBlockingEngine::StepTile(Scratch& scratch, uint32_t tile)
+{
+    const int x0 = static_cast<int>(tile % nTilesX) * tileWidth;
+    const int y0 = static_cast<int>(tile / nTilesX) * tileHeight;
+    const int x1 = std::min(x0 + tileWidth, grid.width);
+    const int y1 = std::min(y0 + tileHeight, grid.height);
+
+    // Scratch cell (x, y) is grid cell (x + originX, y + originY).
+    const int originX = x0 - depth;
+    const int originY = y0 - depth;
+
+    // Cells past the edges of the grid are dead in every generation, so they are zeroed in both scratch grids
+    // and never stepped. Only tiles near an edge have any.
+    const int gridX0 = std::max(originX, 0);
+    const int gridX1 = std::min(x1 + depth, grid.width);
+    const int gridY0 = std::max(originY, 0);
+    const int gridY1 = std::min(y1 + depth, grid.height);
+
+    const bool nearEdge = gridX0 != originX || gridY0 != originY || gridX1 != x1 + depth || gridY1 != y1 + depth;
+    if (nearEdge) {
+        std::fill(scratch.current.cells.begin(), scratch.current.cells.end(), 0);
+        std::fill(scratch.next.cells.begin(), scratch.next.cells.end(), 0);
+    }
+
+    for (int y = gridY0; y < gridY1; ++y) {
+        std::memcpy(Row(scratch.current, y - originY) + (gridX0 - originX), Row(grid, y) + gridX0, gridX1 - gridX0);
+    }
+
+    // After generation g, cells more than depth - g cells outside the tile are no longer valid, so they aren't stepped.
+    for (int generation = 1; generation <= depth; ++generation) {
+        const int margin = depth - generation;
+        const int stepX0 = std::max(x0 - margin, gridX0) - originX;
+        const int stepX1 = std::min(x1 + margin, gridX1) - originX;
+        const int stepY0 = std::max(y0 - margin, gridY0) - originY;
+        const int stepY1 = std::min(y1 + margin, gridY1) - originY;
+
+        StepBlock(scratch.current, scratch.next, stepX0, stepX1, stepY0, stepY1);
+        std::swap(scratch.current, scratch.next);
+    }
+
+    for (int y = y0; y < y1; ++y) {
+        std::memcpy(Row(nextGrid, y) + x0, Row(scratch.current, y - originY) + (x0 - originX), x1 - x0);
+    }
+}
+
+void TemporalBlockingEngine::Step()
+{
+    auto stepTile = [this](int worker, uint32_t tile) { StepTile(scratches[worker], tile); };
+    scheduler.Run(static_cast<uint32_t>(nTilesX * nTilesY), stepTile);
+
+    ++nSteps;
+    std::swap(grid, nextGrid);
+}
+
+void TemporalBlockingEngine::ReportStatistics(std::ostream& stream) const
+{
+    // Each pass reads every tile with its halo and writes the tile back, where stepping one generation at a time
+    // reads and writes the whole grid once per generation.
+    const double gridBytes = static_cast<double>(grid.width) * grid.height;
+    const double haloWidth = 2.0 * depth;
+    const double readBytes = static_cast<double>(nTilesX * nTilesY) * (tileWidth + haloWidth) * (tileHeight + haloWidth);
+    const double bytesPerGeneration = (readBytes + gridBytes) / depth;
+
+    stream << "temporal: " << depth << " generations per pass over " << nTilesX * nTilesY << " tiles of " << tileWidth << "x" << tileHeight
+           << ", about " << bytesPerGeneration / gridBytes << " bytes of grid traffic per cell per generation, against 2 for bytegrid ("
+           << nSteps << " passes)\n";
+    scheduler.ReportStatistics(stream);
+}
+
+void TemporalBlockingEngine::ReportMemoryPlacement(std::ostream& stream) const
+{
+    ReportBandNodes(stream, grid, pool.ThreadCount());
+}
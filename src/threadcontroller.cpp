@@ -0,0 +1,95 @@
+#include "threadcontroller.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace {
+    // How far the best count has to be from the current one, as a ratio, and for how many generations, before it moves.
+    constexpr double hysteresis = 1.5;
+    constexpr int holdGenerations = 8;
+
+    // Weight of the newest measurement in the running averages.
+    constexpr double smoothing = 0.125;
+
+    // Guess at the cost of an extra thread until one has been measured.
+    constexpr double initialSyncNanoseconds = 10000.0;
+}
+
+ThreadCountController::ThreadCountController(std::string_view m_name, int m_maxThreads, ThreadScaling m_scaling)
+    : name(m_name)
+    , maxThreads(std::max(1, m_maxThreads))
+    , scaling(m_scaling)
+    , nThreads(m_scaling.adaptive ? 1 : maxThreads)
+    , syncNanoseconds(initialSyncNanoseconds)
+{
+}
+
+int ThreadCountController::Choose(uint64_t nWorkItems)
+{
+    if (!scaling.adaptive || !measured) {
+        return nThreads;
+    }
+
+    const double best = std::clamp(std::sqrt(static_cast<double>(nWorkItems) * itemNanoseconds / syncNanoseconds), 1.0, static_cast<double>(maxThreads));
+
+    if (best >= nThreads * hysteresis) {
+        ++nGenerationsAbove;
+        nGenerationsBelow = 0;
+    } else if (best <= nThreads / hysteresis) {
+        ++nGenerationsBelow;
+        nGenerationsAbove = 0;
+    } else {
+        nGenerationsAbove = 0;
+        nGenerationsBelow = 0;
+    }
+
+    int next = nThreads;
+    if (nGenerationsAbove >= holdGenerations) {
+        next = std::min({ static_cast<int>(std::ceil(best)), nThreads * 2, maxThreads });
+    } else if (nGenerationsBelow >= holdGenerations) {
+        next = std::max(static_cast<int>(std::floor(best)), (nThreads + 1) / 2);
+    }
+
+    if (next != nThreads) {
+        if (scaling.logDecisions) {
+            std::cout << name << ": " << nThreads << " -> " << next << " threads for " << nWorkItems << " work items at "
+                      << itemNanoseconds << " ns each, " << syncNanoseconds / 1000.0 << " us per extra thread\n";
+        }
+
+        nThreads = next;
+        nGenerationsAbove = 0;
+        nGenerationsBelow = 0;
+        ++nDecisions;
+    }
+
+    return nThreads;
+}
+
+void ThreadCountController::Record(uint64_t nWorkItems, ThreadPool::RunTiming timing)
+{
+    ++nGenerations;
+    nThreadGenerations += nThreads;
+
+    if (nWorkItems > 0) {
+        const double sample = static_cast<double>(timing.busyNanoseconds) / static_cast<double>(nWorkItems);
+        itemNanoseconds = measured ? itemNanoseconds + (smoothing * (sample - itemNanoseconds)) : sample;
+        measured = true;
+    }
+
+    // Whatever the threads took beyond an even share of the work is put down to the extra threads.
+    if (nThreads > 1) {
+        const double evenShare = static_cast<double>(timing.busyNanoseconds) / nThreads;
+        const double sample = std::max(0.0, static_cast<double>(timing.wallNanoseconds) - evenShare) / (nThreads - 1);
+        syncNanoseconds = std::max(1.0, syncNanoseconds + (smoothing * (sample - syncNanoseconds)));
+    }
+}
+
+void ThreadCountController::ReportStatistics(std::ostream& stream) const
+{
+    const double averageThreads = nGenerations == 0 ? 0.0 : static_cast<double>(nThreadGenerations) / static_cast<double>(nGenerations);
+
+    stream << "thread scaling: " << (scaling.adaptive ? "adaptive, " : "fixed, ") << nThreads << " of " << maxThreads
+           << " threads now, " << averageThreads << " on average, " << nDecisions << " changes, " << itemNanoseconds
+           << " ns per work item, " << syncNanoseconds / 1000.0 << " us per extra thread\n";
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "threadpool.hpp"
+
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+
+// ------------------
+// Thread Count Controller
+// ------------------
+
+struct ThreadScaling {
+    // Pick the number of threads for each generation from how much work there is, rather than always using all of them.
+    bool adaptive = false;
+
+    // Print every change of thread count, with the measurements behind it.
+    bool logDecisions = false;
+};
+
+// Picks how many of a pool's threads to step each generation on. A generation of W nanoseconds of work on n threads
+// takes about W / n + s * (n - 1), where s is what waking each extra thread and waiting for it at the barrier costs,
+// which is shortest at n = sqrt(W / s). Both the cost per work item and s are measured from the pool as it runs.
+//
+// The thread count only moves once the best count has been well away from it for several generations in a row,
+// and then by at most a factor of two, so it ramps between one thread and all of them without jitter.
+class ThreadCountController {
+public:
+    ThreadCountController(std::string_view name, int maxThreads, ThreadScaling scaling);
+
+    // Threads to run a generation of nWorkItems cells or tiles on.
+    int Choose(uint64_t nWorkItems);
+
+    // Feed back how the generation Choose() was last asked about went.
+    void Record(uint64_t nWorkItems, ThreadPool::RunTiming timing);
+
+    void ReportStatistics(std::ostream& stream) const;
+
+private:
+    std::string_view name;
+    int maxThreads = 1;
+    ThreadScaling scaling;
+
+    int nThreads = 1;
+
+    // Running averages of the time per work item, and of the cost of each thread past the first.
+    double itemNanoseconds = 0.0;
+    double syncNanoseconds = 0.0;
+    bool measured = false;
+
+    // Generations in a row that the best count has been above or below nThreads.
+    int nGenerationsAbove = 0;
+    int nGenerationsBelow = 0;
+
+    uint64_t nDecisions = 0;
+    uint64_t nThreadGenerations = 0;
+    uint64_t nGenerations = 0;
+};
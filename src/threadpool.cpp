@@ -0,0 +1,151 @@
+#include "threadpool.hpp"
+
+#include "numa.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    uint64_t NanosecondsSince(Clock::time_point start)
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+    }
+}
+
+Band BandOf(int nRows, int thread, int nThreads)
+{
+    return { static_cast<int>((static_cast<int64_t>(nRows) * thread) / nThreads),
+        static_cast<int>((static_cast<int64_t>(nRows) * (thread + 1)) / nThreads) };
+}
+
+ThreadPool::ThreadPool(int m_nThreads, bool m_pinThreads)
+    : nThreads(m_nThreads > 0 ? m_nThreads : std::max(1, static_cast<int>(std::thread::hardware_concurrency())))
+    , pinThreads(m_pinThreads)
+    , statistics(nThreads)
+{
+    // Pinned pools have a worker for thread 0 as well, rather than running it on the caller.
+    const int firstWorker = pinThreads ? 0 : 1;
+    workers.reserve(nThreads - firstWorker);
+    for (int thread = firstWorker; thread < nThreads; ++thread) {
+        workers.emplace_back(&ThreadPool::WorkerLoop, this, thread);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::Run(void* context, TaskFunction function, int nActive)
+{
+    const auto start = Clock::now();
+
+    uint64_t busyBefore = 0;
+    for (const ThreadStatistics& thread : statistics) {
+        busyBefore += thread.busyNanoseconds;
+    }
+
+    // Unless the pool is pinned, the caller runs thread 0, and a task on one thread wakes nobody and needs no barrier.
+    bool wakeWorkers = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        taskContext = context;
+        taskFunction = function;
+        nActiveThreads = std::clamp(nActive, 1, nThreads);
+        nRunning = pinThreads ? nActiveThreads : nActiveThreads - 1;
+
+        wakeWorkers = nRunning > 0;
+        if (wakeWorkers) {
+            ++generation;
+        }
+    }
+
+    if (wakeWorkers) {
+        workAvailable.notify_all();
+    }
+
+    if (!pinThreads) {
+        RunTask(0);
+    }
+
+    // The barrier: nothing the task wrote is read until every thread has finished.
+    if (wakeWorkers) {
+        std::unique_lock<std::mutex> lock(mutex);
+        workFinished.wait(lock, [this] { return nRunning == 0; });
+    }
+
+    uint64_t busyAfter = 0;
+    for (const ThreadStatistics& thread : statistics) {
+        busyAfter += thread.busyNanoseconds;
+    }
+
+    lastRun = { NanosecondsSince(start), busyAfter - busyBefore };
+    ++nRuns;
+    runNanoseconds += lastRun.wallNanoseconds;
+    activeThreadNanoseconds += lastRun.wallNanoseconds * nActiveThreads;
+}
+
+void ThreadPool::WorkerLoop(int thread)
+{
+    if (pinThreads) {
+        PinCurrentThread(thread);
+    }
+
+    uint64_t lastGeneration = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            // Threads past the active ones sit out the task, and pick up whichever one next includes them.
+            workAvailable.wait(lock, [&] { return stopping || (generation != lastGeneration && thread < nActiveThreads); });
+            if (stopping) {
+                return;
+            }
+            lastGeneration = generation;
+        }
+
+        RunTask(thread);
+
+        bool last = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            last = --nRunning == 0;
+        }
+        if (last) {
+            workFinished.notify_one();
+        }
+    }
+}
+
+void ThreadPool::RunTask(int thread)
+{
+    const auto start = Clock::now();
+    taskFunction(taskContext, thread);
+    statistics[thread].busyNanoseconds += NanosecondsSince(start);
+}
+
+void ThreadPool::ReportStatistics(std::ostream& stream) const
+{
+    // Efficiency is the share of the active threads' time inside Run() that they spent working rather than waiting.
+    uint64_t totalBusyNanoseconds = 0;
+    for (const ThreadStatistics& thread : statistics) {
+        totalBusyNanoseconds += thread.busyNanoseconds;
+    }
+    const double efficiency = activeThreadNanoseconds == 0 ? 0.0 : static_cast<double>(totalBusyNanoseconds) / static_cast<double>(activeThreadNanoseconds);
+
+    stream << "thread pool: " << nThreads << " threads, " << nRuns << " runs taking " << runNanoseconds / 1e6 << " ms, "
+           << efficiency * 100.0 << "% efficiency\n";
+    for (int thread = 0; thread < nThreads; ++thread) {
+        stream << "  thread " << thread << ": busy " << statistics[thread].busyNanoseconds / 1e6 << " ms\n";
+    }
+}
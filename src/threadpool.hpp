@@ -0,0 +1,93 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+// ------------------
+// Thread Pool
+// ------------------
+
+// Rows [begin, end) of thread's share when nRows rows are split evenly between nThreads threads.
+struct Band {
+    int begin = 0;
+    int end = 0;
+};
+
+Band BandOf(int nRows, int thread, int nThreads);
+
+// Fixed set of worker threads that live as long as the pool, so a generation costs one wake-up and one barrier
+// rather than creating threads. The thread calling Run() takes part as thread 0, unless the threads are pinned.
+class ThreadPool {
+public:
+    // nThreads of 0 uses one thread per hardware thread. With pinThreads, thread n only runs on the n-th allowed CPU,
+    // so the memory it first touches stays on its NUMA node. Thread 0 is then a worker of its own too, so that the
+    // threads calling Run(), like the render and simulation threads, are never pinned.
+    explicit ThreadPool(int nThreads, bool pinThreads = false);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int ThreadCount() const { return nThreads; }
+
+    // Call task(thread) once on each of the first nActive threads, for thread in [0, nActive), and return once all
+    // calls have. The other threads stay asleep. The task is passed by reference rather than wrapped in a
+    // std::function so that running it never allocates.
+    template <typename Task>
+    void Run(Task& task, int nActive)
+    {
+        Run(&task, [](void* context, int thread) { (*static_cast<Task*>(context))(thread); }, nActive);
+    }
+
+    template <typename Task>
+    void Run(Task& task) { Run(task, nThreads); }
+
+    // Wall time of the last Run(), and the time its threads spent in the task, added up.
+    struct RunTiming {
+        uint64_t wallNanoseconds = 0;
+        uint64_t busyNanoseconds = 0;
+    };
+
+    RunTiming LastRun() const { return lastRun; }
+
+    // Time each thread spent running tasks, against the time Run() took, since the pool was created.
+    void ReportStatistics(std::ostream& stream) const;
+
+private:
+    using TaskFunction = void (*)(void* context, int thread);
+
+    // Written by one thread only, and padded so that threads don't share cache lines.
+    struct alignas(64) ThreadStatistics {
+        uint64_t busyNanoseconds = 0;
+    };
+
+    int nThreads = 1;
+    bool pinThreads = false;
+    std::vector<std::thread> workers;
+    std::vector<ThreadStatistics> statistics;
+
+    std::mutex mutex;
+    std::condition_variable workAvailable;
+    std::condition_variable workFinished;
+
+    // The current task. Each Run() bumps generation, which is how workers tell a new task from one they have done.
+    void* taskContext = nullptr;
+    TaskFunction taskFunction = nullptr;
+    uint64_t generation = 0;
+    int nActiveThreads = 0;
+    int nRunning = 0;
+    bool stopping = false;
+
+    uint64_t nRuns = 0;
+    uint64_t runNanoseconds = 0;
+    uint64_t activeThreadNanoseconds = 0;
+    RunTiming lastRun;
+
+    void Run(void* context, TaskFunction function, int nActive);
+    void WorkerLoop(int thread);
+    void RunTask(int thread);
+};
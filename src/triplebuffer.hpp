@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// ------------------
+// Triple Buffer
+// ------------------
+
+// Hands the newest value from one producer thread to one consumer thread without either ever waiting for the other.
+// The producer fills the back buffer and publishes it, the consumer reads the front buffer, and the third buffer
+// sits between them holding the newest published value. Publishing and picking up swap a buffer with the middle one
+// in a single atomic exchange, so values the consumer was too slow to see are simply overwritten.
+template <typename T>
+class TripleBuffer {
+public:
+    explicit TripleBuffer(const T& initial)
+        : buffers { initial, initial, initial }
+    {
+    }
+
+    // Producer side: the buffer to write the next value into.
+    T& Back() { return buffers[back]; }
+
+    // Producer side: make the back buffer the newest value, and take a free buffer to write the one after into.
+    void Publish()
+    {
+        back = middle.exchange(back | freshBit, std::memory_order_acq_rel) & indexMask;
+    }
+
+    // Consumer side: swap in the newest value if one was published since the last call. Returns whether Front() changed.
+    bool Update()
+    {
+        if ((middle.load(std::memory_order_relaxed) & freshBit) == 0) {
+            return false;
+        }
+
+        front = middle.exchange(front, std::memory_order_acq_rel) & indexMask;
+        return true;
+    }
+
+    // Consumer side: the newest value picked up by Update().
+    const T& Front() const { return buffers[front]; }
+
+private:
+    // The middle buffer's index, and whether it holds a value the consumer hasn't picked up yet.
+    static constexpr uint8_t indexMask = 0b011;
+    static constexpr uint8_t freshBit = 0b100;
+
+    std::array<T, 3> buffers;
+
+    // Each end only ever touches its own index, so only the middle one is shared.
+    alignas(64) std::atomic<uint8_t> middle { 1 };
+    alignas(64) uint8_t back = 2;
+    alignas(64) uint8_t front = 0;
+};
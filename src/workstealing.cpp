@@ -0,0 +1,85 @@
+#include "workstealing.hpp"
+
+namespace {
+    constexpr uint64_t Pack(uint32_t begin, uint32_t end)
+    {
+        return (static_cast<uint64_t>(begin) << 32) | end;
+    }
+
+    constexpr uint32_t Begin(uint64_t range)
+    {
+        return static_cast<uint32_t>(range >> 32);
+    }
+
+    constexpr uint32_t End(uint64_t range)
+    {
+        return static_cast<uint32_t>(range);
+    }
+}
+
+WorkStealingScheduler::WorkStealingScheduler(ThreadPool& m_pool)
+    : pool(m_pool)
+    , workers(m_pool.ThreadCount())
+{
+}
+
+void WorkStealingScheduler::Distribute(uint32_t nTasks)
+{
+    // Neighbouring tasks stay on the same worker, which keeps the cells they touch in that core's cache.
+    const uint64_t nWorkers = nActiveWorkers;
+    for (uint64_t worker = 0; worker < nWorkers; ++worker) {
+        const uint32_t begin = static_cast<uint32_t>((nTasks * worker) / nWorkers);
+        const uint32_t end = static_cast<uint32_t>((nTasks * (worker + 1)) / nWorkers);
+        workers[worker].range.store(Pack(begin, end), std::memory_order_relaxed);
+    }
+}
+
+bool WorkStealingScheduler::Pop(int worker, uint32_t& index)
+{
+    std::atomic<uint64_t>& range = workers[worker].range;
+    uint64_t current = range.load(std::memory_order_relaxed);
+
+    while (Begin(current) < End(current)) {
+        if (range.compare_exchange_weak(current, Pack(Begin(current), End(current) - 1), std::memory_order_relaxed)) {
+            index = End(current) - 1;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool WorkStealingScheduler::Steal(int worker)
+{
+    const int nWorkers = nActiveWorkers;
+
+    // Start with the next worker along, so that thieves spread out over their victims.
+    for (int offset = 1; offset < nWorkers; ++offset) {
+        std::atomic<uint64_t>& victimRange = workers[(worker + offset) % nWorkers].range;
+        uint64_t current = victimRange.load(std::memory_order_relaxed);
+
+        while (Begin(current) < End(current)) {
+            const uint32_t begin = Begin(current);
+            const uint32_t nStolen = (End(current) - begin + 1) / 2;
+
+            if (victimRange.compare_exchange_weak(current, Pack(begin + nStolen, End(current)), std::memory_order_relaxed)) {
+                workers[worker].range.store(Pack(begin, begin + nStolen), std::memory_order_relaxed);
+                ++workers[worker].nSteals;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+void WorkStealingScheduler::ReportStatistics(std::ostream& stream) const
+{
+    stream << "work stealing:";
+    for (size_t worker = 0; worker < workers.size(); ++worker) {
+        stream << " [worker " << worker << ": " << workers[worker].nTasks << " tasks, " << workers[worker].nSteals << " steals]";
+    }
+    stream << "\n";
+
+    pool.ReportStatistics(stream);
+}
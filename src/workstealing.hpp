@@ -0,0 +1,74 @@
+#pragma once
+
+#include "threadpool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// ------------------
+// Work-Stealing Scheduler
+// ------------------
+
+// Runs a batch of independent tasks on a thread pool. Each worker starts with its own deque holding an equal,
+// contiguous share of the tasks, and works through it from the back. A worker whose deque runs dry steals the front
+// half of another worker's deque, so a few expensive tasks can't leave the other threads idle.
+//
+// Tasks never add tasks, so a worker's deque is always a contiguous range of task indices. It is stored as a single
+// atomic word, which lets the owner pop and thieves steal with one compare-and-swap and no locks or allocation.
+class WorkStealingScheduler {
+public:
+    explicit WorkStealingScheduler(ThreadPool& pool);
+
+    // Call task(worker, index) once for every index in [0, nTasks), on the first nWorkers workers,
+    // and return once all calls have.
+    template <typename Task>
+    void Run(uint32_t nTasks, Task& task, int nWorkers)
+    {
+        nActiveWorkers = std::clamp(nWorkers, 1, pool.ThreadCount());
+        Distribute(nTasks);
+
+        auto workerLoop = [this, &task](int worker) {
+            uint32_t index = 0;
+            while (true) {
+                if (Pop(worker, index)) {
+                    task(worker, index);
+                    ++workers[worker].nTasks;
+                } else if (!Steal(worker)) {
+                    break;
+                }
+            }
+        };
+        pool.Run(workerLoop, nActiveWorkers);
+    }
+
+    template <typename Task>
+    void Run(uint32_t nTasks, Task& task) { Run(nTasks, task, pool.ThreadCount()); }
+
+    // Tasks run and steals made by each worker since the scheduler was created, and the pool's busy times.
+    void ReportStatistics(std::ostream& stream) const;
+
+private:
+    // Padded so that each worker's deque and counters are on their own cache line.
+    struct alignas(64) Worker {
+        // Indices [begin, end) packed as (begin << 32) | end.
+        std::atomic<uint64_t> range { 0 };
+        uint64_t nTasks = 0;
+        uint64_t nSteals = 0;
+    };
+
+    ThreadPool& pool;
+    std::vector<Worker> workers;
+    int nActiveWorkers = 0;
+
+    void Distribute(uint32_t nTasks);
+
+    // Take the task at the back of the worker's own deque.
+    bool Pop(int worker, uint32_t& index);
+
+    // Move the front half of some other worker's deque into this worker's empty one.
+    // Returns false once every other deque is empty.
+    bool Steal(int worker);
+};